@@ -0,0 +1,265 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include "../include/Simulation.hpp"
+#include "../include/Random.hpp"
+#include "../include/Recorder.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// ---------------------------
+//  Benchmark de UpdateTraffic : de 20 à 1M voitures
+//  Usage : TrafficBench [--sizes 20,1000,...] [--ticks N] [--threads N] [--json fichier] [--csv fichier]
+//                       [--record fichier]  (mesure aussi le surcoût de l'enregistrement des trajectoires)
+// ---------------------------
+
+const float LANE_WIDTH = 40.0f;
+const float CAR_SPACING = 100.0f;     // espacement initial des voitures sur une voie
+const float MAX_ROAD_LENGTH = 200000.0f; // au-delà, on ajoute des voies (précision des float)
+
+struct BenchResult {
+    int cars = 0;
+    int lanes = 0;
+    int threads = 0;
+    int ticks = 0;
+    double seconds = 0.0;
+    double nsPerCarTick = 0.0;
+    double ticksPerSecond = 0.0;
+    long peakMemoryKB = 0;
+    double stateShare[4] = {0, 0, 0, 0};   // part moyenne de la flotte dans chaque CarState
+    uint64_t recordBytes = 0;              // avec --record : taille du fichier de trajectoires
+    uint64_t recordFrames = 0;             // ticks enregistrés
+    uint64_t recordDropped = 0;            // ticks perdus (anneau plein)
+};
+
+// Pic de mémoire résidente du processus (Ko)
+static long PeakMemoryKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return (long)(pmc.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (long)(usage.ru_maxrss / 1024); // octets sur macOS
+#else
+    return (long)usage.ru_maxrss;          // Ko sur Linux
+#endif
+#endif
+}
+
+// Même disposition que la ville de main.cpp (deux routes en boucle, quatre parkings),
+// étirée et élargie pour garder une densité de trafic constante
+static void BuildLayout(int nbCars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                        std::vector<Car>& cars, int& lanes) {
+    SetSimSeed(2024);
+    int perRoad = std::max(1, nbCars / 2);
+    float length = std::max(1400.0f, std::min(MAX_ROAD_LENGTH, perRoad / 2 * CAR_SPACING));
+    int perLane = std::max(1, (int)(length / CAR_SPACING));
+    lanes = std::max(2, (perRoad + perLane - 1) / perLane);
+
+    roads.clear();
+    float width = lanes * LANE_WIDTH;
+    Road r1;
+    r1.start = {-100, 250};
+    r1.end = {length - 100, 250};
+    r1.lanes = lanes;
+    r1.width = width;
+    r1.light = {r1.end, LIGHT_GREEN, 5.0f};
+    Road r2 = r1;
+    r2.start = {length - 100, 600};
+    r2.end = {-100, 600};
+    r2.light = {r2.end, LIGHT_RED, 5.0f};
+    r1.next = 1;
+    r2.next = 0;
+    roads.push_back(r1);
+    roads.push_back(r2);
+
+    // Capacité proportionnelle à la flotte (au moins celle de la ville d'origine)
+    int scale = std::max(1, nbCars / 200);
+    parkings.clear();
+    parkings.push_back(ParkingLot({100, 70}, {150, 80}, 4 * scale, 15.0f, "VIP", Rgba{0, 121, 241, 255}, {175, 250}));
+    parkings.push_back(ParkingLot({450, 425}, {200, 80}, 6 * scale, 8.0f, "Central", Rgba{200, 122, 255, 255}, {650, 290}));
+    parkings.push_back(ParkingLot({100, 700}, {180, 80}, 5 * scale, 2.0f, "Eco", Rgba{0, 228, 48, 255}, {200, 600}));
+    parkings.push_back(ParkingLot({750, 700}, {250, 80}, 7 * scale, 5.0f, "City", Rgba{255, 161, 0, 255}, {870, 600}));
+
+    cars.clear();
+    cars.reserve(nbCars);
+    for (int i = 0; i < nbCars; i++) {
+        Car c;
+        c.id = i;
+        c.roadIndex = i % 2;
+        int slot = i / 2;
+        c.currentLane = (lanes == 2) ? SimRandomValue(0, 1) : slot % lanes;
+        c.targetLane = c.currentLane;
+        c.distance = (float)((slot / lanes) % perLane) * CAR_SPACING;
+        c.speed = MAX_SPEED;
+        c.laneOffset = -width / 2 + (c.currentLane + 0.5f) * LANE_WIDTH;
+        cars.push_back(c);
+    }
+}
+
+// Nombre de ticks mesurés : budget d'environ 2.10^7 voiture-ticks par taille
+static int DefaultTicks(int nbCars) {
+    return std::max(5, std::min(600, 20000000 / std::max(1, nbCars)));
+}
+
+static BenchResult RunBench(int nbCars, int ticks, int threads, const std::string& recordPath) {
+    std::vector<Road> roads;
+    std::vector<ParkingLot> parkings;
+    std::vector<Car> cars;
+    BenchResult r;
+    BuildLayout(nbCars, roads, parkings, cars, r.lanes);
+
+    TrafficState state(threads);
+    const float dt = 1.0f / 60.0f;
+
+    TrajectoryRecorder recorder;
+    if (!recordPath.empty()) {
+        std::string error;
+        if (recorder.open(recordPath, error)) state.recorder = &recorder;
+        else std::cerr << error << std::endl;
+    }
+
+    // Échauffement (allocation des tampons, premier tri de l'index)
+    int warmup = std::max(2, ticks / 10);
+    for (int t = 0; t < warmup; t++) UpdateTraffic(cars, roads, parkings, dt, state);
+
+    double counts[4] = {0, 0, 0, 0};
+    double seconds = 0.0;
+    for (int t = 0; t < ticks; t++) {
+        auto start = std::chrono::steady_clock::now();
+        UpdateTraffic(cars, roads, parkings, dt, state);
+        auto end = std::chrono::steady_clock::now();
+        seconds += std::chrono::duration<double>(end - start).count();
+
+        // Répartition par état (hors chronométrage)
+        for (const auto& c : cars) counts[c.state] += 1.0;
+    }
+
+    r.cars = nbCars;
+    r.threads = threads;
+    r.ticks = ticks;
+    r.seconds = seconds;
+    r.nsPerCarTick = seconds * 1e9 / ((double)nbCars * ticks);
+    r.ticksPerSecond = ticks / seconds;
+    r.peakMemoryKB = PeakMemoryKB();
+    for (int s = 0; s < 4; s++) r.stateShare[s] = counts[s] / ((double)nbCars * ticks);
+    if (state.recorder) {
+        recorder.close();
+        r.recordBytes = recorder.bytesWritten();
+        r.recordFrames = recorder.framesRecorded();
+        r.recordDropped = recorder.framesDropped();
+    }
+    return r;
+}
+
+static std::vector<int> ParseSizes(const char* text) {
+    std::vector<int> sizes;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int n = std::atoi(item.c_str());
+        if (n > 0) sizes.push_back(n);
+    }
+    return sizes;
+}
+
+static void WriteJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "  {\"cars\": %d, \"lanes\": %d, \"threads\": %d, \"ticks\": %d, \"seconds\": %.6f, "
+                      "\"ns_per_car_tick\": %.3f, \"ticks_per_second\": %.3f, \"peak_memory_kb\": %ld, "
+                      "\"state_share\": {\"driving\": %.5f, \"to_parking\": %.5f, \"parked\": %.5f, \"leaving\": %.5f}}%s\n",
+                      r.cars, r.lanes, r.threads, r.ticks, r.seconds, r.nsPerCarTick, r.ticksPerSecond,
+                      r.peakMemoryKB, r.stateShare[DRIVING], r.stateShare[TO_PARKING], r.stateShare[PARKED],
+                      r.stateShare[LEAVING_PARKING], (i + 1 < results.size()) ? "," : "");
+        out << line;
+    }
+    out << "]\n";
+}
+
+static void WriteCsv(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    out << "cars,lanes,threads,ticks,seconds,ns_per_car_tick,ticks_per_second,peak_memory_kb,"
+           "driving,to_parking,parked,leaving\n";
+    for (const auto& r : results) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%d,%d,%d,%d,%.6f,%.3f,%.3f,%ld,%.5f,%.5f,%.5f,%.5f\n",
+                      r.cars, r.lanes, r.threads, r.ticks, r.seconds, r.nsPerCarTick, r.ticksPerSecond,
+                      r.peakMemoryKB, r.stateShare[DRIVING], r.stateShare[TO_PARKING], r.stateShare[PARKED],
+                      r.stateShare[LEAVING_PARKING]);
+        out << line;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes = {20, 1000, 10000, 100000, 1000000};
+    int ticks = 0; // 0 : selon la taille
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::string jsonPath, csvPath, recordPath;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (!std::strcmp(argv[i], "--sizes") && hasValue) sizes = ParseSizes(argv[++i]);
+        else if (!std::strcmp(argv[i], "--ticks") && hasValue) ticks = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && hasValue) threads = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--json") && hasValue) jsonPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--csv") && hasValue) csvPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--record") && hasValue) recordPath = argv[++i];
+        else {
+            std::cerr << "Usage : " << argv[0]
+                      << " [--sizes 20,1000,...] [--ticks N] [--threads N] [--json fichier] [--csv fichier]"
+                      << " [--record fichier]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Tailles croissantes : le pic mémoire du processus correspond à la taille courante
+    std::sort(sizes.begin(), sizes.end());
+
+    std::printf("%10s %6s %7s %6s %14s %12s %12s %8s %8s %8s %8s\n", "voitures", "voies", "threads", "ticks",
+                "ns/voit-tick", "ticks/s", "pic Mo", "DRIVING", "TO_PARK", "PARKED", "LEAVING");
+    std::vector<BenchResult> results;
+    for (int n : sizes) {
+        int sizeTicks = ticks > 0 ? ticks : DefaultTicks(n);
+        BenchResult r = RunBench(n, sizeTicks, threads, "");
+        std::printf("%10d %6d %7d %6d %14.1f %12.1f %12.1f %7.1f%% %7.1f%% %7.1f%% %7.1f%%\n", r.cars, r.lanes,
+                    r.threads, r.ticks, r.nsPerCarTick, r.ticksPerSecond, r.peakMemoryKB / 1024.0,
+                    100 * r.stateShare[DRIVING], 100 * r.stateShare[TO_PARKING], 100 * r.stateShare[PARKED],
+                    100 * r.stateShare[LEAVING_PARKING]);
+        if (!recordPath.empty()) {
+            // Même mesure avec l'enregistreur branché : seul le coût côté simulation est chronométré
+            BenchResult rec = RunBench(n, sizeTicks, threads, recordPath);
+            std::printf("%10s enregistrement : %+.1f%% par tick, %.1f octets/voiture-tick, %llu ticks perdus\n", "",
+                        100.0 * (rec.nsPerCarTick / r.nsPerCarTick - 1.0),
+                        (double)rec.recordBytes / ((double)n * std::max<uint64_t>(1, rec.recordFrames)),
+                        (unsigned long long)rec.recordDropped);
+        }
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty()) WriteJson(jsonPath, results);
+    if (!csvPath.empty()) WriteCsv(csvPath, results);
+    return 0;
+}
@@ -1,5 +1,22 @@
-#pragma once
-#include "Components.hpp"
-
-// Dessine une voiture avec orientation selon sa direction (route ou parking)
-void DrawCar(const Car& car, const Road& road);
\ No newline at end of file
+#pragma once
+#include "Components.hpp"
+#include <vector>
+
+// Niveau de détail du dessin des voitures (selon le zoom de la caméra)
+enum CarDetail {
+    CAR_DETAIL_FULL,    // modèle complet (roues, vitre, phares...)
+    CAR_DETAIL_BODY,    // carrosserie seule, orientée
+    CAR_DETAIL_POINT    // carré de quelques pixels
+};
+
+// Dessine une voiture avec orientation selon sa direction (route ou parking)
+void DrawCar(const Car& car, const Road& road);
+
+// Dessine toute la flotte par lots rlgl (quelques appels de dessin au lieu d'une dizaine par voiture)
+void DrawCars(const std::vector<Car>& cars, const std::vector<Road>& roads);
+
+// Dessine seulement les voitures d'indices visible (voir CityView), à la pose donnée
+// (pos, angle en degrés : même ordre que visible) et au niveau de détail donné
+// (pointSize : côté du carré en CAR_DETAIL_POINT, en unités monde)
+void DrawCars(const std::vector<Car>& cars, const std::vector<int>& visible, const std::vector<Vec2>& pos,
+              const std::vector<float>& angle, CarDetail detail, float pointSize);
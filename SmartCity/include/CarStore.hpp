@@ -0,0 +1,51 @@
+#pragma once
+#include "Components.hpp"
+#include <cstdint>
+#include <vector>
+
+// Stockage "structure de tableaux" (SoA) de la flotte.
+// Les champs chauds de la cinématique sont contigus (un tableau par champ) pour
+// que la mise à jour vitesse/distance ne lise que ce dont elle a besoin.
+// Le reste de Car (couleur, cibles, parking...) est conservé dans cold.
+class CarStore {
+public:
+    // --- Champs chauds ---
+    std::vector<float> distance;
+    std::vector<float> speed;
+    std::vector<float> laneOffset;
+    std::vector<int32_t> state;       // CarState
+
+    // --- Consignes du tick (écrites par la décision, lues par IntegrateKinematics) ---
+    std::vector<float> targetSpeed;
+    std::vector<float> blend;         // facteur du Lerp de vitesse (1 = freinage d'urgence)
+    std::vector<float> speedCap;      // vitesse plafond (approche parking)
+
+    // --- Champs froids (les champs chauds de cold ne font pas foi) ---
+    std::vector<Car> cold;
+
+    size_t size() const { return distance.size(); }
+    void clear();
+
+    // Adaptateur Car <-> SoA
+    void assign(const std::vector<Car>& cars);
+    void copyTo(std::vector<Car>& cars) const;
+    void push_back(const Car& car);
+    Car get(size_t i) const;
+    void set(size_t i, const Car& car);
+
+    // Chargement des seuls champs chauds (les consignes sont remises à "ne pas bouger")
+    void loadHot(const std::vector<Car>& cars);
+    // Idem pour les seules voitures de only (les autres gardent leurs champs)
+    void loadHot(const std::vector<Car>& cars, const std::vector<int>& only);
+
+private:
+    void resizeHot(size_t n);
+    void loadCar(size_t i, const Car& car);
+};
+
+// Noyau vectorisé (AVX2 / SSE2, repli scalaire) appliqué à toutes les voitures DRIVING :
+//   speed    = min(Lerp(speed, targetSpeed, blend), speedCap)
+//   distance = distance + speed * dt
+void IntegrateKinematics(CarStore& store, float dt);
+// Idem sur la tranche [begin, end) (pour découper le travail entre threads)
+void IntegrateKinematics(CarStore& store, float dt, size_t begin, size_t end);
@@ -0,0 +1,56 @@
+#pragma once
+#include "Simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------------------------
+//  Points de reprise : état complet du monde, restauré à l'identique
+// ---------------------------
+//
+// Contenu : flotte, feux (état + minuterie, temps et phases du contrôleur), échéances des
+// voitures garées endormies, tarifs (prix et données de révision de chaque parking),
+// occupation et registre de chaque parking, horloge, tick et graine des tirages, état du
+// générateur partagé.
+// La disposition (géométrie des routes et des parkings) n'est pas copiée : elle vient du
+// scénario, dont une empreinte est vérifiée à la restauration.
+// Les structures dérivées (index des voies, réseau, tampons) sont reconstruites.
+
+const uint32_t CHECKPOINT_VERSION = 4;
+const char CHECKPOINT_MAGIC[8] = {'S', 'C', 'I', 'T', 'Y', 'C', 'K', 'P'};
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t carSize;           // sizeof(Car) : les voitures sont stockées telles quelles
+    uint32_t roadCount;
+    uint32_t lotCount;
+    int32_t substeps;
+    uint64_t carCount;
+    uint64_t layoutHash;        // empreinte de la disposition (routes, parkings)
+    uint64_t seed;
+    uint64_t tick;
+    uint64_t simRngState;
+    uint64_t clockTick;
+    double fixedDt;
+    double accumulator;
+    double time;
+    double droppedTime;
+};
+
+// Empreinte de la disposition (géométrie et plans de feux des routes, emplacement et capacité des parkings)
+uint64_t LayoutHash(const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings);
+
+// En mémoire (pour brancher plusieurs expériences depuis le même état)
+void WriteCheckpoint(std::vector<uint8_t>& out, const std::vector<Car>& cars, const std::vector<Road>& roads,
+                     const std::vector<ParkingLot>& parkings, const TrafficState& state);
+bool ReadCheckpoint(const uint8_t* data, size_t size, std::vector<Car>& cars, std::vector<Road>& roads,
+                    std::vector<ParkingLot>& parkings, TrafficState& state, std::string& error);
+
+// Dans un fichier
+bool SaveCheckpoint(const std::string& path, const std::vector<Car>& cars, const std::vector<Road>& roads,
+                    const std::vector<ParkingLot>& parkings, const TrafficState& state, std::string& error);
+bool LoadCheckpoint(const std::string& path, std::vector<Car>& cars, std::vector<Road>& roads,
+                    std::vector<ParkingLot>& parkings, TrafficState& state, std::string& error);
@@ -0,0 +1,66 @@
+#pragma once
+#include "raylib.h"
+#include "Components.hpp"
+#include "SimThread.hpp"
+#include "SpatialGrid.hpp"
+#include <vector>
+
+// ---------------------------
+//  Vue de la ville : caméra, culling, niveau de détail
+// ---------------------------
+//
+// Seul ce qui chevauche la vue est parcouru : routes et parkings via une grille
+// uniforme (SpatialGrid), voitures via l'index des voies (portion visible de chaque
+// route visible) et le registre des parkings visibles. Le coût d'une trame dépend
+// donc de ce qui est à l'écran, pas de la taille du monde.
+// Dézoomé, le détail baisse : voitures en carrosserie seule puis en points, parkings
+// en rectangles colorés selon l'occupation, routes sans marquage.
+// Ce qui ne bouge pas (herbe, allées, surfaces, places, marquage, poteaux des feux) est
+// rendu une fois dans une texture à la taille de l'écran, refaite seulement quand la caméra,
+// la fenêtre ou la disposition change ; chaque trame ne dessine par-dessus que les places
+// occupées, les panneaux, les lampes des feux et les voitures.
+// Tout est lu dans un instantané publié par le thread de simulation (WorldSnapshot),
+// les voitures à leur pose interpolée entre les deux derniers pas.
+
+const float MIN_CAMERA_ZOOM = 0.005f;
+const float MAX_CAMERA_ZOOM = 4.0f;
+const float LOD_DETAIL_ZOOM = 0.5f;     // en dessous : voitures en carrosserie, parkings résumés
+const float LOD_POINT_ZOOM = 0.15f;     // en dessous : voitures en points
+
+struct CityView {
+    Camera2D camera = { {0, 0}, {0, 0}, 0.0f, 1.0f };   // vue d'origine : 1 px monde = 1 px écran
+    SpatialGrid roadGrid;
+    SpatialGrid lotGrid;
+    std::vector<int> lotRoads;      // route d'accès de chaque parking (allées)
+
+    // Résultat du culling de la dernière trame
+    Bounds visibleArea = {0, 0, 0, 0};
+    std::vector<int> visibleRoads;
+    std::vector<int> visibleLots;
+    std::vector<int> visibleCars;
+    std::vector<Vec2> shownPos;     // pose affichée de chaque voiture de visibleCars
+    std::vector<float> shownAngle;
+
+    // Couche statique (rendue pour staticCamera)
+    RenderTexture2D staticLayer = RenderTexture2D();
+    Camera2D staticCamera = { {0, 0}, {0, 0}, 0.0f, 1.0f };
+    bool staticValid = false;
+    int staticRedraws = 0;
+};
+
+// (Re)construit les grilles de routes et de parkings (géométrie statique du scénario)
+void BuildCityView(CityView& view, const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings);
+
+// Molette : zoom vers le curseur ; clic droit ou milieu glissé : déplacement ;
+// Début : vue d'origine ; F : toute la ville à l'écran
+void UpdateCityCamera(CityView& view, int screenW, int screenH);
+
+// Libère la couche statique (avant CloseWindow)
+void UnloadCityView(CityView& view);
+
+// Cadre toute la ville dans l'écran
+void FitCityView(CityView& view, int screenW, int screenH);
+
+// Dessine la partie visible du monde (allées, parkings, routes, feux, voitures) avec la caméra.
+// now : horloge murale (SimWallClock) de la trame, pour l'interpolation des voitures.
+void DrawCity(CityView& view, const WorldSnapshot& world, double now, int screenW, int screenH);
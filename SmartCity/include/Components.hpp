@@ -1,91 +1,111 @@
-#pragma once
-#include "raylib.h"
-#include "raymath.h"
-#include <vector>
-
-const float CAR_LENGTH = 40.0f;
-const float CAR_WIDTH = 20.0f;
-const float SAFE_DISTANCE = 160.0f;
-const float MAX_SPEED = 200.0f;
-
-enum LightState { LIGHT_GREEN, LIGHT_YELLOW, LIGHT_RED };
-enum CarState { DRIVING, TO_PARKING, PARKED, LEAVING_PARKING };
-
-struct TrafficLight {
-    Vector2 position;
-    LightState state;
-    float timer;
-    void update(float dt);
-};
-
-struct Road {
-    Vector2 start;
-    Vector2 end;
-    int lanes;
-    float width;
-    TrafficLight light;
-
-    float getLength() const { return Vector2Distance(start, end); }
-    Vector2 getDir() const { return Vector2Normalize(Vector2Subtract(end, start)); }
-};
-
-struct Car {
-    int id;
-    int roadIndex;
-    float rotation;
-    int currentLane;
-    float distance;
-    float speed;
-    Color color;
-
-    float laneOffset;
-    int targetLane;
-    float laneChangeTimer;
-
-    CarState state;
-    Vector2 worldPos;
-    Vector2 targetPos;
-    float waitTimer;
-    int parkingIdx;
-    int spotIdx;
-
-    // Constructeur pour initialiser proprement
-    Car() : id(0), roadIndex(0), currentLane(0), distance(0), speed(0), color(RED),
-            laneOffset(0), targetLane(0), laneChangeTimer(0),
-            state(DRIVING), worldPos({0,0}), targetPos({0,0}),
-            waitTimer(0), parkingIdx(-1), spotIdx(-1) {}
-};
-
-struct ParkingLot {
-    Vector2 position;
-    Vector2 size;
-    int capacity;
-    std::vector<bool> spotsOccupied;
-    float price;
-    const char* name;
-    Color color;
-    Vector2 exitPos;
-    
-
-    // Constructeur bien défini
-    
-    ParkingLot(Vector2 pos, Vector2 sz, int cap, float pr, const char* nm, Color col, Vector2 exit)
-    : position(pos), size(sz), capacity(cap), price(pr), name(nm), color(col), exitPos(exit), spotsOccupied(cap, false) 
-    {}
-
-    // Méthodes membre
-    int firstFreeSpot() const {
-        for (int i = 0; i < capacity; i++) {
-            if (!spotsOccupied[i]) return i;
-        }
-        return -1;
-    }
-
-    void occupySpot(int idx) {
-        if (idx >= 0 && idx < capacity) spotsOccupied[idx] = true;
-    }
-
-    void freeSpot(int idx) {
-        if (idx >= 0 && idx < capacity) spotsOccupied[idx] = false;
-    }
-};
\ No newline at end of file
+#pragma once
+#include "SimMath.hpp"
+#include "SpotBitmap.hpp"
+#include <cstdint>
+#include <vector>
+
+const float CAR_LENGTH = 40.0f;
+const float CAR_WIDTH = 20.0f;
+const float SAFE_DISTANCE = 160.0f;
+const float MAX_SPEED = 200.0f;
+
+enum LightState { LIGHT_GREEN, LIGHT_YELLOW, LIGHT_RED };
+enum CarState { DRIVING, TO_PARKING, PARKED, LEAVING_PARKING };
+enum SignalMode : int32_t { SIGNAL_FIXED, SIGNAL_ACTUATED };
+
+// État affiché d'un feu, tenu par le contrôleur des feux (SignalController).
+// Au chargement, état et minuterie donnent la phase de départ du feu.
+struct TrafficLight {
+    Vec2 position;
+    LightState state;
+    float timer;        // temps restant dans la phase, calculé au dernier changement
+};
+
+// Plan d'un feu (voir SignalController)
+struct SignalPlan {
+    SignalMode mode = SIGNAL_FIXED;
+    float cycle = 12.0f;    // durée du cycle (s)
+    float green = 5.0f;     // vert (adaptatif : vert du premier cycle)
+    float yellow = 2.0f;
+};
+
+struct Road {
+    Vec2 start;
+    Vec2 end;
+    int lanes = 2;
+    float width = 80.0f;
+    TrafficLight light;
+    SignalPlan signal;
+    int next = -1;      // route empruntée ensuite (-1 : déduite du réseau, voir RoadNetwork)
+
+    float getLength() const { return Vec2Distance(start, end); }
+    Vec2 getDir() const { return Vec2Normalize(Vec2Subtract(end, start)); }
+    // Abscisse curviligne d'un point projeté sur l'axe de la route
+    float projectDistance(Vec2 p) const {
+        Vec2 dir = getDir();
+        Vec2 v = Vec2Subtract(p, start);
+        return v.x * dir.x + v.y * dir.y;
+    }
+};
+
+struct Car {
+    int id;
+    int roadIndex;
+    float rotation;
+    int currentLane;
+    float distance;
+    float speed;
+    Rgba color;
+
+    float laneOffset;
+    int targetLane;
+    float laneChangeTimer;
+
+    CarState state;
+    Vec2 worldPos;
+    Vec2 targetPos;
+    float waitTimer;    // garée : attente ; en route : délai avant un nouveau parking, ou validité de la réservation
+    int parkingIdx;
+    int spotIdx;        // place occupée, ou réservée (en route vers parkingIdx)
+
+    // Constructeur pour initialiser proprement
+    Car() : id(0), roadIndex(0), rotation(0), currentLane(0), distance(0), speed(0), color({230, 41, 55, 255}),
+            laneOffset(0), targetLane(0), laneChangeTimer(0),
+            state(DRIVING), worldPos({0,0}), targetPos({0,0}),
+            waitTimer(0), parkingIdx(-1), spotIdx(-1) {}
+};
+
+struct ParkingLot {
+    Vec2 position;
+    Vec2 size;
+    int capacity;
+    SpotBitmap spotsOccupied;   // occupation des places (compteur tenu à jour)
+    float price;                // prix courant (révisé par la tarification dynamique)
+    float basePrice;            // prix du scénario, référence de la tarification
+    const char* name;
+    Rgba color;
+    Vec2 exitPos;
+    int roadIndex = -1;         // route d'accès (-1 : la plus proche de exitPos)
+    int lane = -1;              // voie d'accès (-1 : voie extérieure du côté du parking)
+
+    // Registre des manœuvres : indices (handles) des voitures engagées vers ce parking
+    std::vector<int> entering;  // en approche sur la route ou en train de se garer
+    std::vector<int> parked;
+    std::vector<int> leaving;
+
+    // Constructeur bien défini
+    
+    ParkingLot(Vec2 pos, Vec2 sz, int cap, float pr, const char* nm, Rgba col, Vec2 exit)
+    : position(pos), size(sz), capacity(cap), spotsOccupied(cap), price(pr), basePrice(pr), name(nm), color(col), exitPos(exit)
+    {}
+
+    // Méthodes membre (temps constant, ou O(log64 n) pour la recherche)
+    int firstFreeSpot() const { return spotsOccupied.findFirstFree(); }
+    bool isOccupied(int idx) const { return idx >= 0 && idx < capacity && spotsOccupied.test(idx); }
+    int occupiedCount() const { return spotsOccupied.count(); }
+    bool isFull() const { return spotsOccupied.full(); }
+    int committedCount() const { return (int)(entering.size() + parked.size() + leaving.size()); }
+
+    void occupySpot(int idx) { spotsOccupied.set(idx); }
+    void freeSpot(int idx) { spotsOccupied.reset(idx); }
+};
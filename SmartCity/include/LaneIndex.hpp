@@ -0,0 +1,89 @@
+#pragma once
+#include "Components.hpp"
+#include <vector>
+
+// Index spatial des voitures par (route, voie), trié par distance croissante.
+// Remplace les parcours complets de la flotte pour trouver le leader, le suiveur
+// ou vérifier qu'une portion de voie est libre.
+// Les voitures sont désignées par leur indice dans la flotte (handle stable :
+// la flotte n'est plus triée, c'est l'index qui porte l'ordre des voies).
+//  - lanes : voitures DRIVING et TO_PARKING (clé = car.distance)
+//  - exits : voitures LEAVING_PARKING (clé = projection de targetPos sur la route)
+class LaneIndex {
+public:
+    // Reconstruction complète, O(n log n) (à égalité de distance, l'indice le plus grand est derrière)
+    void rebuild(const std::vector<Car>& cars, const std::vector<Road>& roads);
+
+    // Mise à jour depuis l'état courant de la flotte, quasi linéaire : les clés sont
+    // mises à jour en place puis chaque voie est retriée par insertion (les dépassements
+    // sont rares). Seules les voitures qui changent de route, de voie ou d'état migrent.
+    // Reconstruit tout si la taille de la flotte, des routes ou le nombre de voies change.
+    void sync(const std::vector<Car>& cars, const std::vector<Road>& roads);
+    // Idem en ne relisant que les voitures de changed (les autres n'ont pas bougé depuis
+    // la dernière mise à jour) : coût proportionnel aux voitures qui bougent
+    void sync(const std::vector<Car>& cars, const std::vector<Road>& roads, const std::vector<int>& changed);
+
+    // --- Maintenance incrémentale pendant le tick ---
+    void moveCar(int carIdx, float newDistance);            // la voiture a avancé sur sa voie
+    void insertCar(int carIdx, int road, int lane, float distance);
+    void removeCar(int carIdx);                              // sortie de la voie (garée, changement de route)
+    void insertLeaving(int carIdx, int road, int lane, float projectedDistance);
+    void removeLeaving(int carIdx);
+
+    // --- Requêtes O(log n) ---
+    // Voiture la plus proche devant (distance strictement supérieure), -1 si aucune
+    int leader(int road, int lane, float distance) const;
+    // Voiture juste devant carIdx dans l'ordre de sa voie (à égalité de distance, l'ordre
+    // de l'index départage), -1 si aucune ou si carIdx n'est pas indexée
+    int leaderOf(int carIdx) const;
+    // Voiture la plus proche derrière (distance strictement inférieure), -1 si aucune
+    int follower(int road, int lane, float distance) const;
+    // Distance projetée de la voiture sortante la plus proche devant, +inf si aucune
+    float nearestLeavingAhead(int road, int lane, float distance) const;
+    // Y a-t-il une voiture (autre que excludeCar) dans l'intervalle ouvert ]lo, hi[ ?
+    bool anyInRange(int road, int lane, float lo, float hi, int excludeCar) const;
+    // Y a-t-il une voiture (autre que excludeCar) à moins de range de distance ?
+    bool anyWithin(int road, int lane, float distance, float range, int excludeCar) const;
+
+    // Parcourt les voitures de ]lo, hi[ par distance croissante; fn(carIdx, distance) renvoie false pour arrêter
+    template <typename Fn>
+    void forEachInRange(int road, int lane, float lo, float hi, Fn fn) const {
+        const std::vector<Entry>* b = bucket(lanes, road, lane);
+        if (!b) return;
+        for (size_t i = upperBound(*b, lo); i < b->size() && (*b)[i].key < hi; i++) {
+            if (!fn((*b)[i].car, (*b)[i].key)) return;
+        }
+    }
+
+    int laneCount() const { return laneStride; }
+
+private:
+    struct Entry {
+        float key;
+        int car;
+    };
+    struct Slot {
+        int bucket = -1;
+        int pos = -1;
+    };
+
+    std::vector<std::vector<Entry>> lanes;
+    std::vector<std::vector<Entry>> exits;
+    std::vector<Slot> laneSlot;   // position de chaque voiture dans lanes
+    std::vector<Slot> exitSlot;   // position de chaque voiture dans exits
+    std::vector<int> laneMigrants;  // tampons de sync()
+    std::vector<int> exitMigrants;
+    int roadCount = 0;
+    int laneStride = 0;
+
+    int bucketId(int road, int lane) const;
+    const std::vector<Entry>* bucket(const std::vector<std::vector<Entry>>& set, int road, int lane) const;
+    static size_t upperBound(const std::vector<Entry>& b, float key);
+    static size_t lowerBound(const std::vector<Entry>& b, float key);
+    static void insertEntry(std::vector<std::vector<Entry>>& set, std::vector<Slot>& slots, int id, int carIdx, float key);
+    static void eraseEntry(std::vector<std::vector<Entry>>& set, std::vector<Slot>& slots, int carIdx);
+    static void insertionSort(std::vector<Entry>& b, std::vector<Slot>& slots);
+    void ensureCar(int carIdx);
+    void syncKey(int carIdx, const Car& car);
+    void finishSync(const std::vector<Car>& cars, const std::vector<Road>& roads);
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "Components.hpp"
+#include "RoadNetwork.hpp"
+#include "SpatialGrid.hpp"
+#include <limits>
+#include <utility>
+#include <vector>
+
+// ---------------------------
+//  Recherche des parkings disponibles
+// ---------------------------
+//
+// Un arbre k-d par voie sur la position des parkings qu'elle dessert (RoadNetwork::lotsOnLane).
+// Chaque noeud porte la boîte de son sous-arbre et le prix le plus bas parmi ses parkings
+// disponibles (au moins une place libre ; +inf s'il n'y en a aucun). Une requête "k plus
+// proches disponibles sous le prix P" écarte donc d'un coup les sous-arbres trop loin, pleins
+// ou trop chers : O(log n) en pratique, même avec des milliers de parkings par quartier.
+// Le choix au coût distance + prix borne chaque sous-arbre par distance à la boîte + prix minimal,
+// et écarte les sous-arbres dont toutes les entrées sont derrière la voiture (abscisse maximale
+// des entrées sur la route).
+// Disponibilité et prix sont tenus à jour parking par parking (update, en O(log n)) ;
+// refresh relit tous les parkings et ne touche que ceux qui ont changé.
+// Les requêtes sont en lecture seule (parallélisables) ; les mises à jour en série.
+
+class LotIndex {
+public:
+    // Arbres des voies du réseau (le réseau doit être construit pour ces parkings)
+    void build(const RoadNetwork& network, const std::vector<ParkingLot>& parkings);
+    bool matches(const std::vector<ParkingLot>& parkings) const { return built && price.size() == parkings.size(); }
+
+    // Disponibilité et prix d'un parking relus (remontée jusqu'à la racine s'ils ont changé)
+    void update(int lot, const ParkingLot& parking);
+    void refresh(const std::vector<ParkingLot>& parkings);
+
+    // Parking disponible le plus proche de from (distance à ParkingLot::position) parmi ceux
+    // de la voie, au prix <= maxPrice ; à égalité, le plus petit indice. -1 si aucun.
+    int nearest(int road, int lane, Vec2 from, float maxPrice = std::numeric_limits<float>::max()) const;
+    // Les k plus proches, du plus proche au plus lointain (même ordre que nearest)
+    void nearest(int road, int lane, Vec2 from, int k, float maxPrice, std::vector<int>& out) const;
+    // Parking disponible de la voie au coût distance + priceWeight x prix le plus bas
+    // (priceWeight : distance qu'un conducteur accepte de faire en plus pour une unité de prix
+    // en moins), parmi ceux dont l'entrée est au-delà de l'abscisse after (devant la voiture) ;
+    // à égalité, le plus petit indice. -1 si aucun.
+    int cheapest(int road, int lane, Vec2 from, float priceWeight,
+                 float after = -std::numeric_limits<float>::max()) const;
+
+    bool available(int lot) const { return free[lot] != 0; }
+
+private:
+    struct Node {
+        int lot = -1;
+        int left = -1;
+        int right = -1;
+        int parent = -1;
+        Bounds box;             // positions des parkings du sous-arbre
+        float minPrice = 0.0f;  // prix minimal des parkings disponibles du sous-arbre
+        float maxEntrance = 0.0f;   // abscisse maximale des entrées du sous-arbre
+    };
+
+    int buildNode(std::vector<int>& lots, int begin, int end, int depth, int parent);
+    float ownPrice(int lot) const { return free[lot] ? price[lot] : std::numeric_limits<float>::infinity(); }
+    void pull(int node);
+    // best : les count meilleurs (distance, parking) triés, count <= k
+    void search(int node, Vec2 from, size_t k, float maxPrice, std::pair<float, int>* best, size_t& count) const;
+    // best : meilleur (coût, parking) trouvé, parking -1 tant qu'aucun
+    void searchCheapest(int node, Vec2 from, float priceWeight, float after, std::pair<float, int>& best) const;
+    int root(int road, int lane) const;
+
+    std::vector<Node> nodes;
+    std::vector<int> laneRoot;      // indexé par laneBase[road] + lane, -1 si la voie ne dessert rien
+    std::vector<int> laneBase;
+    std::vector<int> lotNode;       // noeud de chaque parking (-1 : parking sans voie d'accès)
+    std::vector<Vec2> position;
+    std::vector<float> entrance;    // abscisse de l'entrée sur la route d'accès (RoadNetwork::lotEntrance)
+    std::vector<float> price;
+    std::vector<unsigned char> free;
+    bool built = false;
+};
@@ -1,11 +1,26 @@
-#pragma once
-#include "Components.hpp"
-
-// Met à jour le parking (étoffé ici, vide car la gestion est faite par voitures)
-void UpdateParking(ParkingLot& p);
-
-// Dessine le parking avec ses places et panneaux infos
-void DrawParking(const ParkingLot& p);
-
-// Calcule la position finale (x,y) d'une place donnée dans un parking
-Vector2 GetSpotPosition(const ParkingLot& p, int spotIndex);
\ No newline at end of file
+#pragma once
+#include "Components.hpp"
+
+// Met à jour le parking (étoffé ici, vide car la gestion est faite par voitures)
+void UpdateParking(ParkingLot& p);
+
+// Calcule la position finale (x,y) d'une place donnée dans un parking
+Vec2 GetSpotPosition(const ParkingLot& p, int spotIndex);
+
+// Voiture lue d'un fichier (scénario, point de reprise) utilisable telle quelle : état connu,
+// route et voies existantes, parking et place dans leurs bornes, et une voiture en manœuvre
+// (entrée, garée, sortie) tient une place de son parking
+bool ValidCar(const Car& c, const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings);
+
+// Registre des manœuvres (listes entering / parked / leaving de chaque parking). slots donne,
+// par voiture, sa position dans la liste qui la contient (-1 : aucune) : une voiture sort de
+// sa liste en O(1) (échange avec la dernière), même dans un parking de dizaines de milliers
+// de places. L'ordre des listes n'a donc pas de sens.
+// Reconstruction complète depuis l'état de la flotte
+void RebuildLotRegistry(const std::vector<Car>& cars, std::vector<ParkingLot>& parkings, std::vector<int>& slots);
+// slots depuis des listes déjà remplies (point de reprise) ; false si les listes ne sont pas
+// celles de la flotte (voiture absente, en trop, hors flotte ou dans la mauvaise liste)
+bool IndexLotRegistry(const std::vector<Car>& cars, std::vector<ParkingLot>& parkings, std::vector<int>& slots);
+// Met à jour les listes pour la voiture carIdx passée de l'état before à after
+void UpdateLotRegistry(int carIdx, const Car& before, const Car& after, std::vector<ParkingLot>& parkings,
+                       std::vector<int>& slots);
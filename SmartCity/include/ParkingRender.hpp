@@ -0,0 +1,15 @@
+#pragma once
+#include "Components.hpp"
+
+// Dessine le parking avec ses places et panneaux infos
+void DrawParking(const ParkingLot& p);
+
+// Les deux moitiés de DrawParking : ce qui ne change pas (surface, places), à mettre en
+// cache, puis ce qui change (panneau avec le prix, places occupées), à dessiner par-dessus
+void DrawParkingLayout(const ParkingLot& p);
+void DrawParkingOccupancy(const ParkingLot& p);
+
+// Version dézoomée : rectangle coloré selon l'occupation, sans les places
+void DrawParkingSummary(const ParkingLot& p);
+void DrawParkingSummaryLayout(const ParkingLot& p);
+void DrawParkingSummaryOccupancy(const ParkingLot& p);
@@ -0,0 +1,85 @@
+#pragma once
+#include "Components.hpp"
+#include <cstddef>
+#include <vector>
+
+// ---------------------------
+//  Tarification dynamique des parkings
+// ---------------------------
+//
+// Toutes les PricingPolicy::interval secondes, le prix de chaque parking est révisé d'après
+// son occupation (écart à l'occupation visée), la tendance de cette occupation depuis la
+// révision précédente et l'heure de la journée (pointe de demande en milieu de journée) :
+//   cible = base x heure x (1 + gainOccupation x (occupation - visée) + gainTendance x tendance)
+// bornée à [minFactor, maxFactor] x base ; le prix ne s'en rapproche que de maxStep (relatif)
+// par révision. La base est ParkingLot::basePrice, jamais le prix déjà révisé, relevée à
+// PricingPolicy::minBasePrice : un parking gratuit reste sinon à 0 quelle que soit la demande.
+// Les données sont rangées par champ (SoA) et la révision est un noyau vectorisé (AVX2 /
+// SSE2, repli scalaire) : seule la lecture de l'occupation passe par les parkings. Le prix
+// révisé est écrit dans ParkingLot::price.
+
+// Tendance ramenée à 0 sous ce seuil : une occupation stable la fait décroître vers 0, sans
+// passer par les flottants dénormalisés (très lents)
+const float PRICING_TREND_EPSILON = 1e-6f;
+
+// Réglages d'une étude de gestion de la demande
+struct PricingPolicy {
+    double interval = 60.0;             // s entre deux révisions
+    float targetOccupancy = 0.85f;      // occupation visée (0..1)
+    float occupancyGain = 1.5f;         // hausse relative par point d'occupation au-dessus de la visée
+    float trendGain = 2.0f;             // anticipation : hausse relative par point gagné depuis la révision précédente
+    float trendSmoothing = 0.5f;        // lissage de la tendance (1 : dernière variation seule)
+    float minFactor = 0.5f;             // bornes du prix, relatives au prix de base
+    float maxFactor = 3.0f;
+    float maxStep = 0.25f;              // variation relative maximale par révision
+    double dayLength = 86400.0;         // s
+    double dayStart = 8.0 * 3600.0;     // heure de la journée au temps 0 des tarifs
+    float peakAmplitude = 0.3f;         // hausse relative à la pointe (midi), nulle à minuit
+    float minBasePrice = 1.0f;          // plancher du prix de base (dh/h)
+};
+
+// Données des parkings, un tableau par champ (indexés comme les parkings)
+struct LotPrices {
+    std::vector<float> base;            // prix du scénario (relevé au plancher)
+    std::vector<float> price;           // prix courant
+    std::vector<float> occupancy;       // occupation à la dernière révision (0..1)
+    std::vector<float> trend;           // variation lissée de l'occupation par révision
+};
+
+class PricingEngine {
+public:
+    // Prix de base = ParkingLot::basePrice (au moins policy.minBasePrice) ; le prix courant est
+    // repris, ramené dans les bornes (et réécrit) ; première révision dans policy.interval
+    void build(std::vector<ParkingLot>& parkings);
+    bool matches(const std::vector<ParkingLot>& parkings) const { return built && lots.base.size() == parkings.size(); }
+
+    // Avance le temps des tarifs de dt ; révise les prix si c'est l'heure (renvoie true)
+    bool update(double dt, std::vector<ParkingLot>& parkings);
+    // Révision immédiate : lit l'occupation, applique le noyau, écrit ParkingLot::price
+    void reprice(std::vector<ParkingLot>& parkings);
+
+    // Facteur de l'heure de la journée au temps t des tarifs
+    float timeOfDayFactor(double t) const;
+
+    double now() const { return time; }
+    double nextRevision() const { return next; }
+    const LotPrices& getLots() const { return lots; }
+
+    // Points de reprise : reprend le temps, la prochaine révision et les données des parkings
+    // (les prix courants sont réécrits dans parkings)
+    bool restore(double savedTime, double savedNext, const LotPrices& saved, std::vector<ParkingLot>& parkings);
+
+    PricingPolicy policy;
+
+private:
+    LotPrices lots;
+    std::vector<float> measured;        // occupation lue à la révision en cours
+    double time = 0.0;
+    double next = 0.0;
+    bool built = false;
+};
+
+// Noyau de révision des parkings [begin, end) : met à jour trend, occupancy et price depuis
+// measured (indexé comme les parkings ; formule ci-dessus, heure = factor)
+void RepriceLots(LotPrices& lots, const float* measured, const PricingPolicy& policy, float factor,
+                 size_t begin, size_t end);
@@ -0,0 +1,119 @@
+#pragma once
+#include "Trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ---------------------------
+//  Profileur de ticks et de trames
+// ---------------------------
+//
+// Des chronomètres de portée (ProfileScope) mesurent les phases d'un tick (thread de
+// simulation) et d'une trame (rendu). Chaque tick / trame donne un enregistrement
+// (durée de chaque zone, en ms) rangé dans un anneau des PROFILE_HISTORY derniers,
+// d'où l'on tire médiane et p99 (affichage en surimpression, export CSV).
+// Le profileur est éteint par défaut (setEnabled) : éteint, un chronomètre ne lit pas
+// l'horloge et rien n'est enregistré. Les durées de l'enregistrement en cours sont cumulées
+// par thread (une piste est close par le thread qui la mesure, et des simulations menées
+// sur des threads différents ne se mélangent pas) ; l'anneau est protégé par un mutex
+// (une prise par tick ou par trame, rien par voiture).
+// Avec SMARTCITY_TRACE, chaque zone apparaît aussi dans la trace d'exécution (Trace.hpp).
+
+enum ProfileTrack {
+    PROF_TRACK_SIM,         // un enregistrement par tick (UpdateTraffic)
+    PROF_TRACK_RENDER,      // un enregistrement par trame
+    PROF_TRACK_COUNT
+};
+
+enum ProfileZone {
+    // Tick
+    PROF_TICK,              // UpdateTraffic complet
+    PROF_LIGHTS,            // feux
+    PROF_LANE_SORT,         // mise à jour (tri) de l'index des voies
+    PROF_SENSE,             // phase 1 : tirages et recherche d'obstacles
+    PROF_DECIDE,            // phase 2 : logique par état et cinématique
+    PROF_COMMIT,            // phase 3 : actions sur les parkings, enregistrement, échange
+    PROF_PUBLISH,           // copie de l'instantané pour le rendu (entre deux ticks)
+    // Trame
+    PROF_FRAME,             // trame complète (hors attente de l'affichage)
+    PROF_DRAW_STATIC,       // couche statique (copie, ou nouveau rendu si la vue a changé)
+    PROF_DRAW_PARKINGS,     // occupation des parkings
+    PROF_DRAW_LIGHTS,       // lampes des feux
+    PROF_DRAW_CARS,         // culling, interpolation et dessin des voitures
+    PROF_DRAW_UI,           // tableau de bord, curseurs, textes
+    PROF_ZONE_COUNT
+};
+
+const int PROFILE_HISTORY = 240;
+
+struct ProfileStats {
+    float last = 0.0f;
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    int samples = 0;
+};
+
+class Profiler {
+public:
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Ajoute ms à la zone dans l'enregistrement en cours du thread appelant
+    void add(ProfileZone zone, double ms);
+    // Clôt l'enregistrement en cours du thread appelant pour la piste (fin du tick / de la trame)
+    void endRecord(ProfileTrack track);
+
+    // Historique d'une zone, du plus ancien au plus récent (ms)
+    void history(ProfileZone zone, std::vector<float>& out) const;
+    ProfileStats stats(ProfileZone zone) const;
+
+    // Export CSV : une ligne par enregistrement de l'historique (piste, numéro, ms par zone)
+    bool dump(const std::string& path, std::string& error) const;
+    // Vide l'historique et l'enregistrement en cours du thread appelant (aucun tick ni trame
+    // ne doit être en cours)
+    void clear();
+
+    static const char* zoneName(ProfileZone zone);
+    static ProfileTrack zoneTrack(ProfileZone zone);
+
+private:
+    std::atomic<bool> enabled{false};
+    mutable std::mutex mutex;
+    float ring[PROF_TRACK_COUNT][PROFILE_HISTORY][PROF_ZONE_COUNT] = {};
+    uint64_t records[PROF_TRACK_COUNT] = {};     // enregistrements clos depuis le début
+};
+
+// Profileur partagé par la simulation et le rendu
+Profiler& GlobalProfiler();
+
+// Chronomètre la portée et l'ajoute à la zone (rien si le profileur est éteint)
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone zone)
+        : zone(zone), active(GlobalProfiler().isEnabled())
+#ifdef SMARTCITY_TRACE
+        , trace(Profiler::zoneName(zone))
+#endif
+    {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    ~ProfileScope() {
+        if (!active) return;
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        GlobalProfiler().add(zone, elapsed.count());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone zone;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+#ifdef SMARTCITY_TRACE
+    TraceScope trace;
+#endif
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Générateur pseudo-aléatoire reproductible (SplitMix64).
+// Remplace GetRandomValue de raylib dans le coeur de simulation.
+struct Rng {
+    uint64_t state;
+
+    explicit Rng(uint64_t seed = 0x5EEDu) : state(seed) {}
+
+    uint64_t next();
+    // Entier dans [min, max], bornes incluses (comme GetRandomValue)
+    int range(int min, int max);
+};
+
+// Générateur partagé (placement initial des scénarios)
+Rng& SimRng();
+void SetSimSeed(uint64_t seed);
+int SimRandomValue(int min, int max);
+
+// Flux du générateur à compteur utilisés par la simulation (un par type de tirage)
+enum DrawStream : uint32_t {
+    DRAW_PARK_ROLL = 0,   // décision d'aller se garer (0..500)
+    DRAW_DWELL = 1,       // durée de stationnement en secondes (15..25)
+    DRAW_TURN = 2         // choix de la route suivante à un carrefour
+};
+
+// Générateur "à compteur", sans état : chaque tirage est une fonction pure de
+// (graine, clé, compteur, flux). Avec clé = id de la voiture et compteur = tick,
+// les tirages ne dépendent ni de l'ordre d'évaluation ni du nombre de threads.
+uint32_t CounterHash(uint64_t seed, uint32_t key, uint64_t counter, uint32_t stream);
+// Entier dans [min, max], bornes incluses
+int CounterRange(uint64_t seed, uint32_t key, uint64_t counter, uint32_t stream, int min, int max);
+// Tirages en lot (AVX2 / SSE2, repli scalaire) :
+//   out[i] = CounterRange(seed, keys[i], counter, stream, min, max)
+void CounterRangeBatch(uint64_t seed, const uint32_t* keys, size_t count, uint64_t counter,
+                       uint32_t stream, int min, int max, int32_t* out);
@@ -0,0 +1,130 @@
+#pragma once
+#include "Components.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------
+//  Enregistrement des trajectoires (analyse hors ligne)
+// ---------------------------
+//
+// Le thread de simulation copie l'état de chaque voiture dans un anneau SPSC sans verrou
+// (une case par tick). Un thread d'écriture encode les ticks et les écrit par blocs :
+//   en-tête de fichier | bloc | bloc | ...
+//   bloc = TrajectoryChunkHeader + trames ; trame = varint(écart de tick) varint(nb voitures)
+//          puis, par voiture, 5 varints zigzag : x, y, vitesse, état, parkingIdx
+// Positions et vitesses sont quantifiées (1/TRAJECTORY_SCALE), chaque valeur est codée en
+// delta par rapport à la trame précédente du bloc (la première trame d'un bloc est complète :
+// chaque bloc se décode seul).
+
+const char TRAJECTORY_MAGIC[8] = {'S', 'C', 'I', 'T', 'Y', 'T', 'R', 'J'};
+const uint32_t TRAJECTORY_VERSION = 1;
+const uint32_t TRAJECTORY_CHUNK_MAGIC = 0x434A5254u;   // "TRJC"
+const float TRAJECTORY_SCALE = 100.0f;                 // 1/100 px, 1/100 px/s
+const int TRAJECTORY_FRAMES_PER_CHUNK = 64;
+
+struct TrajectoryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    float scale;
+    uint32_t framesPerChunk;
+};
+
+struct TrajectoryChunkHeader {
+    uint32_t magic;
+    uint32_t frameCount;
+    uint64_t firstTick;
+    uint64_t payloadSize;       // octets de trames qui suivent
+};
+
+// État des voitures à un tick (SoA, indices = handles de la flotte)
+struct TrajectoryFrame {
+    uint64_t tick = 0;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> speed;
+    std::vector<uint8_t> state;
+    std::vector<int32_t> parkingIdx;
+
+    size_t size() const { return x.size(); }
+    void resize(size_t n);
+};
+
+class TrajectoryRecorder {
+public:
+    TrajectoryRecorder() {}
+    ~TrajectoryRecorder() { close(); }
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    // ringSlots : ticks d'avance tolérés sur le thread d'écriture.
+    // waitWhenFull : si l'anneau est plein, attendre (sans perte) plutôt que perdre le tick.
+    bool open(const std::string& path, std::string& error, int ringSlots = 16, bool waitWhenFull = false);
+    // Vide l'anneau, écrit le dernier bloc et arrête le thread d'écriture
+    void close();
+    bool isOpen() const { return writer.joinable(); }
+
+    // Côté simulation : copie l'état de la flotte (sans allocation une fois la taille atteinte)
+    void record(uint64_t tick, const std::vector<Car>& cars);
+
+    // Même chose en trois temps, pour copier pendant le tick tant que les voitures sont en cache
+    // (UpdateTraffic) : réserver une case (nullptr si l'anneau est plein et le tick perdu),
+    // la remplir par tranches disjointes (éventuellement en parallèle), puis la publier
+    TrajectoryFrame* beginFrame(uint64_t tick, size_t carCount);
+    static void capture(TrajectoryFrame& frame, const std::vector<Car>& cars, size_t begin, size_t end);
+    void publish();
+
+    uint64_t framesRecorded() const { return recorded.load(std::memory_order_relaxed); }
+    uint64_t framesDropped() const { return dropped.load(std::memory_order_relaxed); }
+    uint64_t bytesWritten() const { return written.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+    void encodeFrame(const TrajectoryFrame& frame);
+    void flushChunk();
+
+    std::ofstream file;
+    std::thread writer;
+    std::vector<TrajectoryFrame> ring;
+    alignas(64) std::atomic<uint64_t> head{0};   // prochaine case écrite par la simulation
+    alignas(64) std::atomic<uint64_t> tail{0};   // prochaine case lue par le thread d'écriture (ligne de cache à part)
+    std::atomic<bool> stopping{false};
+    bool waitWhenFull = false;
+
+    // Thread d'écriture uniquement
+    std::vector<uint8_t> chunk;         // tampon du bloc en cours (chunkBytes octets utilisés)
+    size_t chunkBytes = 0;
+    uint32_t chunkFrames = 0;
+    uint64_t chunkFirstTick = 0;
+    uint64_t lastTick = 0;
+    std::vector<int32_t> previous;      // valeurs quantifiées de la trame précédente (5 par voiture)
+
+    std::atomic<uint64_t> recorded{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> written{0};
+};
+
+// Relecture d'un fichier de trajectoires, trame par trame
+class TrajectoryReader {
+public:
+    bool open(const std::string& path, std::string& error);
+    // Trame suivante ; false en fin de fichier ou si le fichier est corrompu (voir error())
+    bool next(TrajectoryFrame& frame);
+    const std::string& error() const { return lastError; }
+
+private:
+    bool loadChunk();
+
+    std::ifstream file;
+    std::vector<uint8_t> chunk;
+    size_t cursor = 0;
+    uint32_t framesLeft = 0;
+    uint64_t tick = 0;
+    std::vector<int32_t> previous;
+    float scale = TRAJECTORY_SCALE;
+    std::string lastError;
+};
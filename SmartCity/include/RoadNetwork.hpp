@@ -0,0 +1,95 @@
+#pragma once
+#include "Components.hpp"
+#include <cstdint>
+#include <vector>
+
+// Carrefour (ou extrémité) du réseau : les routes qui y arrivent et qui en partent
+struct RoadNode {
+    Vec2 position;
+    std::vector<int> incoming;
+    std::vector<int> outgoing;
+};
+
+// Route orientée, avec sa géométrie précalculée (plus de sqrt/normalize par voiture et par tick)
+struct RoadSegment {
+    int from = -1;           // noeud de départ
+    int to = -1;             // noeud d'arrivée
+    Vec2 start;
+    Vec2 end;
+    float length = 0.0f;
+    Vec2 dir;                // direction unitaire
+    Vec2 normal;             // {-dir.y, dir.x} : côté des voies d'indice croissant
+    float heading = 0.0f;    // angle de dir en degrés, dans [0, 360[
+    int lanes = 1;
+    float laneWidth = 0.0f;
+    float firstLaneOffset = 0.0f;   // décalage de la voie 0 par rapport à l'axe
+
+    float laneOffset(int lane) const { return firstLaneOffset + lane * laneWidth; }
+    Vec2 pointAt(float distance, float offset) const {
+        return Vec2Add(Vec2Add(start, Vec2Scale(dir, distance)), Vec2Scale(normal, offset));
+    }
+    // Abscisse curviligne d'un point projeté sur l'axe
+    float project(Vec2 p) const {
+        Vec2 v = Vec2Subtract(p, start);
+        return v.x * dir.x + v.y * dir.y;
+    }
+    // Distance signée d'un point à l'axe (positive du côté de normal)
+    float sideOffset(Vec2 p) const {
+        Vec2 v = Vec2Subtract(p, start);
+        return v.x * normal.x + v.y * normal.y;
+    }
+};
+
+// Réseau routier : noeuds + segments orientés, construit à partir des routes.
+//  - Les extrémités distantes de moins de NODE_TOLERANCE sont fusionnées en un noeud.
+//  - Road::next relie explicitement une route à la suivante (même si elles ne se
+//    touchent pas : la voiture est alors téléportée, comme la boucle de la ville).
+//  - Chaque parking est rattaché à une route et une voie d'accès (ParkingLot::roadIndex/lane,
+//    ou à défaut la route la plus proche de sa sortie, voie du côté du parking).
+//  - Une voiture ne voit au-delà de la fin de sa route (file sur la suivante) que si la
+//    suivante est connue d'avance (forcedSuccessor) et contiguë : après un carrefour à
+//    plusieurs sorties, elle ne découvre la file qu'une fois engagée.
+class RoadNetwork {
+public:
+    static constexpr float NODE_TOLERANCE = 1.0f;
+
+    void build(const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings);
+    // Le réseau a-t-il été construit pour ces routes et parkings ? (comparaison des tailles)
+    bool matches(const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings) const {
+        return built && segments.size() == roads.size() && lotRoads.size() == parkings.size();
+    }
+
+    int segmentCount() const { return (int)segments.size(); }
+    const RoadSegment& segment(int idx) const { return segments[idx]; }
+    const std::vector<RoadNode>& getNodes() const { return nodes; }
+
+    // Segment emprunté après idx par une voiture : lien explicite, sinon une des routes
+    // sortantes du noeud d'arrivée (tirage reproductible (graine, id, tick) s'il y en a
+    // plusieurs, demi-tour évité), sinon idx lui-même (impasse : retour au début)
+    int successor(int idx, uint32_t carId, uint64_t seed, uint64_t tick) const;
+    // Idem quand il ne dépend d'aucun tirage (lien explicite, une seule sortie, impasse), -1 sinon
+    int forcedSuccessor(int idx) const;
+    // La fin de from touche-t-elle le début de to ? (sinon passage par téléportation)
+    bool continuous(int from, int to) const;
+
+    // --- Accès aux parkings ---
+    int lotRoad(int lot) const { return lotRoads[lot]; }
+    int lotLane(int lot) const { return lotLanes[lot]; }
+    float lotEntrance(int lot) const { return lotEntrances[lot]; }   // abscisse de l'entrée sur la route
+    // Parkings desservis par une voie, par indice croissant
+    const std::vector<int>& lotsOnLane(int road, int lane) const;
+
+private:
+    bool uTurn(int from, int to) const;     // to est la route inverse de from
+
+    std::vector<RoadNode> nodes;
+    std::vector<RoadSegment> segments;
+    std::vector<int> explicitNext;
+    std::vector<int> lotRoads;
+    std::vector<int> lotLanes;
+    std::vector<float> lotEntrances;
+    std::vector<std::vector<int>> laneLots;   // indexé par laneLotsBase[road] + lane
+    std::vector<int> laneLotsBase;
+    std::vector<int> noLots;
+    bool built = false;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "Components.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// ---------------------------
+//  Scénarios : routes, parkings et flotte chargés depuis un fichier
+// ---------------------------
+//
+// Format texte (éditable à la main), une entrée par ligne, '#' pour les commentaires :
+//   seed    <graine>
+//   road    <x0> <y0> <x1> <y1> <voies> <largeur> <feu G|Y|R> <minuterie> [route suivante]
+//   signal  <route> <fixe|adaptatif> <cycle> <vert> <jaune>   (plan du feu, sinon fixe 12 / 5 / 2)
+//   wave    <vitesse> <route> <route> ...                     (vague verte, après les lignes signal des routes)
+//   parking <nom> <x> <y> <l> <h> <places> <prix> <r> <g> <b> <a> <sortieX> <sortieY> [route voie]
+//   car     <route> <voie> <distance> <vitesse> [<r> <g> <b> <a>]
+//   fleet   <nombre> [vitesse]   (flotte répartie sur les routes comme dans main.cpp)
+//
+// Format binaire compilé (.scb), versionné, projeté en mémoire (mmap) et lu sur place :
+//   ScenarioHeader | Road[roadCount] | ScenarioLotRecord[lotCount] | Car[carCount] | noms
+// Chaque bloc est aligné sur SCENARIO_ALIGN octets. Routes et voitures sont stockées
+// telles quelles (types trivialement copiables) : le chargement est une copie en bloc,
+// et les noms des parkings pointent directement dans la projection.
+
+const uint32_t SCENARIO_VERSION = 2;
+const uint32_t SCENARIO_ENDIAN_TAG = 0x01020304u;
+const uint64_t SCENARIO_ALIGN = 64;
+const char SCENARIO_MAGIC[8] = {'S', 'C', 'I', 'T', 'Y', 'S', 'C', 'B'};
+
+struct ScenarioHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;         // relu tel quel : détecte un fichier d'une autre boutienne
+    uint32_t roadSize;          // sizeof des enregistrements : détecte un changement de disposition
+    uint32_t lotSize;
+    uint32_t carSize;
+    uint32_t roadCount;
+    uint32_t lotCount;
+    uint32_t reserved;
+    uint64_t carCount;
+    uint64_t seed;
+    uint64_t roadsOffset;
+    uint64_t lotsOffset;
+    uint64_t carsOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t fileSize;
+};
+
+// Parking tel qu'il est stocké (ParkingLot contient des vecteurs et un pointeur de nom)
+struct ScenarioLotRecord {
+    Vec2 position;
+    Vec2 size;
+    int32_t capacity;
+    float price;
+    Rgba color;
+    Vec2 exitPos;
+    int32_t roadIndex;
+    int32_t lane;
+    uint32_t nameOffset;        // dans le bloc des noms (chaînes terminées par '\0')
+};
+
+// Fichier .scb projeté en lecture seule. Non copiable ; la projection doit survivre
+// aux parkings instanciés (leurs noms pointent dedans).
+class MappedScenario {
+public:
+    MappedScenario() {}
+    ~MappedScenario() { close(); }
+    MappedScenario(MappedScenario&& other) noexcept;
+    MappedScenario& operator=(MappedScenario&& other) noexcept;
+    MappedScenario(const MappedScenario&) = delete;
+    MappedScenario& operator=(const MappedScenario&) = delete;
+
+    // Projette le fichier et vérifie l'en-tête et les bornes des blocs
+    bool open(const std::string& path, std::string& error);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const ScenarioHeader& header() const { return *(const ScenarioHeader*)data; }
+    uint64_t seed() const { return header().seed; }
+    size_t roadCount() const { return header().roadCount; }
+    size_t lotCount() const { return header().lotCount; }
+    size_t carCount() const { return (size_t)header().carCount; }
+
+    // Accès sur place, sans copie
+    const Road* roads() const { return (const Road*)(data + header().roadsOffset); }
+    const ScenarioLotRecord* lots() const { return (const ScenarioLotRecord*)(data + header().lotsOffset); }
+    const Car* cars() const { return (const Car*)(data + header().carsOffset); }
+    const char* lotName(size_t lot) const { return (const char*)(data + header().namesOffset) + lots()[lot].nameOffset; }
+
+    // Copie en bloc vers les conteneurs de la simulation (places occupées reconstruites
+    // depuis la flotte). Échoue si une voiture n'est pas valide (ValidCar : état, route,
+    // voies, parking ou place hors bornes).
+    bool instantiate(std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                     std::vector<Car>& cars, std::string& error) const;
+
+private:
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// Scénario chargé : propriétaire des noms (format texte) ou de la projection (binaire)
+struct Scenario {
+    uint64_t seed = 0x5EEDu;
+    std::vector<Road> roads;
+    std::vector<ParkingLot> parkings;
+    std::vector<Car> cars;
+
+    std::deque<std::string> names;   // adresses stables : ParkingLot::name pointe dedans
+    MappedScenario mapping;
+};
+
+// Lecture du format texte (erreur : "fichier:ligne: message")
+bool LoadScenarioText(const std::string& path, Scenario& out, std::string& error);
+// Écriture du format binaire
+bool SaveScenarioBinary(const std::string& path, uint64_t seed, const std::vector<Road>& roads,
+                        const std::vector<ParkingLot>& parkings, const std::vector<Car>& cars,
+                        std::string& error);
+// Charge un fichier texte ou binaire (reconnu à son en-tête)
+bool LoadScenario(const std::string& path, Scenario& out, std::string& error);
@@ -0,0 +1,100 @@
+#pragma once
+#include "Components.hpp"
+#include "LaneIndex.hpp"
+#include "RoadNetwork.hpp"
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// ---------------------------
+//  Contrôleur des feux
+// ---------------------------
+//
+// Chaque feu (fin de route) suit un plan : cycle, vert, jaune (Road::signal). L'état est une
+// fonction du temps simulé des feux : position dans le cycle -> vert / jaune / rouge. Rien
+// n'est décompté par feu et par tick : chaque feu a l'heure de son prochain changement
+// dans un tas, et un tick ne touche que les feux qui changent (quelques-uns par seconde,
+// même avec des milliers de carrefours).
+//  - Fixe : le feu garde sa phase initiale (état et minuterie de Road::light, comme les
+//    scénarios existants), cycle après cycle. Une vague verte (ApplyGreenWave) décale ces
+//    phases le long d'un axe.
+//  - Adaptatif : les feux adaptatifs qui arrivent au même noeud forment un carrefour et
+//    passent au vert l'un après l'autre dans un cycle commun. À chaque début de cycle, le
+//    vert de chacun est recalculé d'après la file mesurée sur ses voies (voitures arrêtées
+//    avant la ligne d'arrêt, voie la plus chargée). Le cycle ne change pas : le début du
+//    vert du premier feu reste calé, la coordination (vague verte) est conservée.
+
+// Ligne d'arrêt, en amont de la fin de route
+const float SIGNAL_STOP_OFFSET = 200.0f;
+// Adaptatif : vert minimal, temps de vert par voiture en file, part minimale laissée au
+// trafic transversal (non simulé) quand le carrefour n'a qu'un feu
+const float SIGNAL_MIN_GREEN = 3.0f;
+const float SIGNAL_DISCHARGE_HEADWAY = 2.0f;
+const float SIGNAL_MIN_RED = 2.0f;
+// File : voitures à moins de SIGNAL_QUEUE_RANGE en amont de la ligne, plus lentes que SIGNAL_QUEUE_SPEED
+const float SIGNAL_QUEUE_RANGE = 600.0f;
+const float SIGNAL_QUEUE_SPEED = 30.0f;
+
+// Feu d'une route, dans le cycle de son carrefour
+struct SignalHead {
+    int road = -1;
+    int junction = -1;
+    float greenStart = 0.0f;    // début du vert dans le cycle (s)
+    float greenTime = 0.0f;
+    float yellow = 0.0f;
+    float stopLine = 0.0f;      // abscisse de la ligne d'arrêt sur la route
+    int queue = 0;              // file mesurée au dernier début de cycle
+    double nextSwitch = 0.0;    // prochain changement d'état (temps des feux)
+};
+
+// Carrefour : feux qui partagent un cycle (un seul feu s'il est fixe)
+struct SignalJunction {
+    bool actuated = false;
+    float cycle = 0.0f;
+    double cycleStart = 0.0;    // début du cycle en cours (temps des feux)
+    std::vector<int> heads;     // ordre de passage au vert
+};
+
+class SignalController {
+public:
+    // Carrefours et phases depuis les plans et l'état courant des feux (Road::light, puis
+    // réécrit : un feu adaptatif prend sa place dans la séquence de son carrefour)
+    void build(std::vector<Road>& roads, const RoadNetwork& network);
+    bool matches(const std::vector<Road>& roads) const { return built && heads.size() == roads.size(); }
+
+    // Avance le temps des feux de dt et applique les changements dus (Road::light).
+    // index doit être à jour avec cars (mesure des files).
+    void update(double dt, std::vector<Road>& roads, const std::vector<Car>& cars, const LaneIndex& index);
+
+    // Minuterie de chaque feu = temps restant maintenant (sinon écrite seulement aux changements)
+    void writeRemaining(std::vector<Road>& roads) const;
+
+    double now() const { return time; }
+    const std::vector<SignalHead>& getHeads() const { return heads; }
+    const std::vector<SignalJunction>& getJunctions() const { return junctions; }
+
+    // Points de reprise : reprend le temps, le début de cycle des carrefours et les phases des
+    // feux (greenStart, greenTime, queue, nextSwitch) après build sur la même disposition
+    bool restore(double savedTime, const std::vector<SignalHead>& savedHeads, const std::vector<double>& cycleStarts);
+
+private:
+    void planJunction(int j, const std::vector<Road>& roads, const std::vector<Car>& cars, const LaneIndex* index);
+    double phaseAt(int h, LightState& state) const;
+    void evaluate(int h, std::vector<Road>& roads);
+    void rebuildQueue();
+
+    std::vector<SignalHead> heads;          // un par route
+    std::vector<SignalJunction> junctions;
+    // Événements (heure, id) : id < carrefours -> début de cycle, sinon feu (id - carrefours).
+    // Entrées périmées ignorées (heure différente de celle du feu ou du carrefour).
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>,
+                        std::greater<std::pair<double, int>>> events;
+    double time = 0.0;
+    bool built = false;
+};
+
+// Vague verte : cale les phases initiales des routes de corridor (dans l'ordre de passage)
+// pour qu'un peloton à speed arrive à chaque ligne d'arrêt au début du vert. Toutes les
+// routes prennent le cycle de la première.
+void ApplyGreenWave(std::vector<Road>& roads, const std::vector<int>& corridor, float speed);
@@ -0,0 +1,33 @@
+#pragma once
+#include <cmath>
+
+// Types mathématiques du coeur de simulation, sans dépendance à raylib.
+// Le rendu convertit vers Vector2 / Color (voir Utils.hpp).
+
+struct Vec2 {
+    float x;
+    float y;
+};
+
+struct Rgba {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+};
+
+inline Vec2 Vec2Add(Vec2 a, Vec2 b) { return { a.x + b.x, a.y + b.y }; }
+inline Vec2 Vec2Subtract(Vec2 a, Vec2 b) { return { a.x - b.x, a.y - b.y }; }
+inline Vec2 Vec2Scale(Vec2 v, float s) { return { v.x * s, v.y * s }; }
+inline float Vec2DotProduct(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+inline float Vec2Length(Vec2 v) { return std::sqrt(v.x * v.x + v.y * v.y); }
+inline float Vec2Distance(Vec2 a, Vec2 b) { return Vec2Length(Vec2Subtract(a, b)); }
+
+inline Vec2 Vec2Normalize(Vec2 v) {
+    float len = Vec2Length(v);
+    if (len > 0.0f) return Vec2Scale(v, 1.0f / len);
+    return { 0.0f, 0.0f };
+}
+
+// Interpolation linéaire (même formule que Lerp de raymath)
+inline float LerpF(float start, float end, float amount) { return start + amount * (end - start); }
@@ -0,0 +1,124 @@
+#pragma once
+#include "Simulation.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------------------------
+//  Simulation sur son propre thread
+// ---------------------------
+//
+// Le thread de simulation avance par pas fixes (StepSimulation) au rythme de l'horloge
+// murale x échelle de temps, puis publie un instantané immuable du monde par triple
+// tampon : il écrit toujours dans une case libre, le rendu lit toujours une case complète,
+// aucun des deux n'attend l'autre. Le rendu interpole la pose des voitures entre
+// l'instantané publié précédent et le dernier, sur la durée murale qui les sépare :
+// l'affichage reste fluide quel que soit le nombre de pas (et de sous-pas) par publication.
+
+// Triple tampon à un producteur et un consommateur
+template <typename T>
+class TripleBuffer {
+public:
+    // Producteur : case à remplir, puis publish() la rend lisible (en remplaçant une
+    // publication pas encore lue)
+    T& back() { return slots[backIdx]; }
+    void publish() { backIdx = middle.exchange(backIdx | FRESH, std::memory_order_acq_rel) & INDEX; }
+    // Une publication attend d'être lue
+    bool pending() const { return (middle.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // Consommateur : prend la dernière publication s'il y en a une nouvelle
+    bool acquire() {
+        if (!pending()) return false;
+        frontIdx = middle.exchange(frontIdx, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots[frontIdx]; }
+
+private:
+    static constexpr int INDEX = 3;
+    static constexpr int FRESH = 4;
+    T slots[3];
+    int backIdx = 0;
+    int frontIdx = 1;
+    std::atomic<int> middle{2};
+};
+
+// État du monde publié pour le rendu (copie : la simulation continue pendant le dessin)
+struct WorldSnapshot {
+    uint64_t tick = 0;              // pas fixes exécutés (clock.tick)
+    double time = 0.0;              // temps simulé (s)
+    double publishedAt = 0.0;       // horloge murale de la publication (SimWallClock)
+    double tickInterval = 0.0;      // durée murale depuis la publication précédente (0 : pas d'interpolation)
+
+    std::vector<Car> cars;
+    std::vector<Vec2> prevPos;      // pose de chaque voiture à la publication précédente (vide : pas d'interpolation)
+    std::vector<float> prevAngle;   // degrés
+    std::vector<Road> roads;        // feux
+    std::vector<ParkingLot> parkings;   // occupation et registre des manœuvres
+    LaneIndex index;                // à jour avec cars (culling du rendu)
+    bool registryValid = false;     // registre des parkings à jour avec cars
+    ParkingSearchStats parkingStats;    // recherches de place depuis le début
+};
+
+// Horloge murale monotone (s), commune au thread de simulation et au rendu
+double SimWallClock();
+
+// Position (centre) et orientation (degrés) d'une voiture dans le monde
+void CarWorldPose(const Car& car, const std::vector<Road>& roads, Vec2& pos, float& angle);
+
+class SimulationThread {
+public:
+    // Le thread s'approprie la flotte, les routes, les parkings et l'état : ne plus y
+    // toucher directement entre start() et stop() (passer par post())
+    SimulationThread(std::vector<Car>& cars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                     TrafficState& state);
+    ~SimulationThread() { stop(); }
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Publie l'état initial puis lance le thread
+    void start();
+    // Termine le pas en cours, exécute les commandes en attente et arrête le thread
+    void stop();
+    bool running() const { return worker.joinable(); }
+
+    void setTimeScale(float scale) { timeScaleValue.store(scale, std::memory_order_relaxed); }
+    float timeScale() const { return timeScaleValue.load(std::memory_order_relaxed); }
+
+    // Exécute fn sur le thread de simulation, entre deux pas (points de reprise, ...)
+    void post(std::function<void()> fn);
+
+    // Côté rendu : prend le dernier instantané publié (true s'il est nouveau)
+    bool acquire() { return snapshots.acquire(); }
+    const WorldSnapshot& latest() const { return snapshots.front(); }
+
+    uint64_t publications() const { return published.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void runPosted();
+    void publish(double now);
+
+    std::vector<Car>& cars;
+    std::vector<Road>& roads;
+    std::vector<ParkingLot>& parkings;
+    TrafficState& state;
+
+    TripleBuffer<WorldSnapshot> snapshots;
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+    std::atomic<float> timeScaleValue{1.0f};
+    std::atomic<uint64_t> published{0};
+
+    std::mutex postMutex;
+    std::vector<std::function<void()>> posted;
+    std::vector<std::function<void()>> executing;    // commandes en cours (thread de simulation)
+    bool dirty = true;                               // état pas encore publié
+    bool previousValid = false;                      // lastPos : poses du même monde, à la publication précédente
+    std::vector<Vec2> lastPos;                       // poses de la dernière publication
+    std::vector<float> lastAngle;
+    double lastPublishedAt = 0.0;
+    double lastPublishedTime = 0.0;                  // temps simulé de la dernière publication
+};
@@ -1,9 +1,148 @@
-#pragma once
-#include "Components.hpp"
-#include <vector>
-
-// Vérifie si la voie est libre (pour changement de voie)
-bool IsLaneFree(const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myId);
-
-// Mise à jour complète du trafic automobile, y compris parkings
-void UpdateTraffic(std::vector<Car>& cars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings, float dt);
\ No newline at end of file
+#pragma once
+#include "Components.hpp"
+#include "LaneIndex.hpp"
+#include "LotIndex.hpp"
+#include "Pricing.hpp"
+#include "CarStore.hpp"
+#include "ThreadPool.hpp"
+#include "RoadNetwork.hpp"
+#include "SignalController.hpp"
+#include "TimingWheel.hpp"
+#include "Random.hpp"
+#include <cstdint>
+#include <vector>
+
+// Ce qu'une voiture perçoit de son environnement, calculé en lecture seule
+// sur l'état du tick précédent (phase "sense")
+struct CarPerception {
+    float distToObstacle;   // DRIVING / TO_PARKING : obstacle le plus proche devant
+    bool roadClear;         // PARKED : la route est libre au point de sortie
+};
+
+// Actions sur les parkings partagés, décidées en parallèle puis appliquées en série
+enum CarIntent : unsigned char {
+    INTENT_NONE = 0,
+    INTENT_CHOOSE_LOT = 1,     // la voiture a choisi un parking (quota à vérifier)
+    INTENT_CLAIM_SPOT = 2,     // la voiture est à l'entrée et demande une place
+    INTENT_EXIT = 4,           // la voiture garée veut sortir
+    INTENT_RELEASE_SPOT = 8,   // la voiture a quitté sa place
+    INTENT_REGISTRY = 16,      // la voiture change de liste dans le registre de son parking
+    INTENT_NO_LOT = 32,        // la voiture voulait se garer, aucun parking de sa voie n'est disponible devant elle
+    INTENT_EXPIRED = 64        // la réservation de la voiture a expiré
+};
+
+// Réservation : la place est prise dès que le parking est choisi (application des actions,
+// en série dans l'ordre de la flotte : deux voitures ne peuvent pas obtenir la même place),
+// puis gardée RESERVATION_TTL secondes d'approche au plus. Une approche abandonnée
+// (mauvaise voie, route suivante, entrée dépassée, expiration) rend la place.
+const float RESERVATION_TTL = 30.0f;
+
+// Entrée d'un parking : la place est demandée à moins de LOT_ENTRY_WINDOW de l'entrée ;
+// au-delà, derrière la voiture, l'entrée est dépassée et l'approche abandonnée.
+// Seuls les parkings dont l'entrée est devant la voiture sont choisis.
+const float LOT_ENTRY_WINDOW = 10.0f;
+
+// Choix du parking : coût = distance + PRICE_DISTANCE_WEIGHT x prix (distance, en px,
+// qu'un conducteur accepte de faire en plus pour 1 dh/h de moins)
+const float PRICE_DISTANCE_WEIGHT = 40.0f;
+
+// Compteurs des recherches de place, cumulés (observation : hors points de reprise)
+struct ParkingSearchStats {
+    uint64_t searches = 0;          // parkings choisis
+    uint64_t reservations = 0;      // places réservées au choix
+    uint64_t failedSearches = 0;    // parkings choisis sans s'y garer (un échec par recherche abandonnée)
+    uint64_t noLot = 0;             // envies de se garer sans parking disponible devant la voiture
+    uint64_t cancelled = 0;         // réservations rendues (approche abandonnée)
+    uint64_t expired = 0;           // réservations expirées
+    double wastedDistance = 0.0;    // distance d'approche parcourue vers un parking sans s'y garer
+};
+
+// Horloge à pas fixe : le temps écoulé est accumulé puis consommé par pas de fixedDt,
+// chaque pas étant découpé en substeps appels à UpdateTraffic. Le résultat ne dépend
+// donc ni de la fréquence d'affichage ni de l'échelle de temps.
+struct SimClock {
+    double fixedDt = 1.0 / 60.0;    // durée d'un pas de simulation (s)
+    int substeps = 1;               // sous-pas par pas fixe
+    int maxStepsPerFrame = 2000;    // garde-fou pour StepSimulation (pas de spirale de rattrapage)
+
+    double accumulator = 0.0;       // temps en attente d'être simulé
+    double time = 0.0;              // temps simulé écoulé
+    uint64_t tick = 0;              // nombre de pas fixes exécutés
+    double droppedTime = 0.0;       // temps abandonné quand le garde-fou a été atteint
+};
+
+class TrajectoryRecorder;
+
+// État conservé entre deux ticks : index, tampon arrière, pool de threads.
+// Le résultat d'un tick ne dépend pas du nombre de threads.
+struct TrafficState {
+    explicit TrafficState(int threadCount = 1) : pool(threadCount) {}
+
+    uint64_t seed = 0x5EEDu;            // graine des tirages (clé : id de voiture, compteur : tick)
+    uint64_t tick = 0;                  // nombre d'appels à UpdateTraffic
+
+    RoadNetwork network;                // géométrie précalculée, reconstruite si routes/parkings changent de nombre
+    SignalController signals;           // feux (construit au premier tick depuis Road::light et Road::signal)
+    LotIndex lots;                      // parkings disponibles par voie (construit avec le réseau)
+    PricingEngine pricing;              // tarifs dynamiques (prix de base relus avec le réseau)
+    bool dynamicPricing = true;         // prix révisés d'après l'occupation (false : prix du scénario)
+    float priceWeight = PRICE_DISTANCE_WEIGHT;
+    LaneIndex index;
+    CarStore kin;                       // cinématique DRIVING (SoA)
+    std::vector<Car> next;              // tampon arrière (état du tick suivant)
+    std::vector<CarPerception> perception;
+    std::vector<unsigned char> intents;
+    std::vector<uint32_t> carIds;       // ids des voitures actives, clés des tirages en lot
+    std::vector<int32_t> parkRoll;      // tirages du tick (DRAW_PARK_ROLL), par rang dans active
+    std::vector<int32_t> dwell;         // tirages du tick (DRAW_DWELL), par rang dans active
+    int registryCars = -1;              // taille de flotte pour laquelle le registre des parkings est à jour
+    std::vector<int> registrySlot;      // position de chaque voiture dans sa liste du registre (-1 : aucune)
+    bool reserveSpots = true;           // place réservée au choix du parking (false : attribuée à l'arrivée)
+    ParkingSearchStats parkingStats;
+    std::vector<float> approachStart;   // abscisse de chaque voiture au choix de son parking
+
+    // Voitures garées endormies : hors du tick jusqu'à la fin de leur attente (waitTimer).
+    // Une voiture endormie est identique dans les deux tampons et son waitTimer n'est plus
+    // décompté (l'échéance est dans parkedWheel). Après une modification de la flotte hors
+    // du tick (NoteFleetEdit), le tick suivant réveille les voitures endormies modifiées.
+    TimingWheel parkedWheel;
+    std::vector<int> active;            // voitures traitées au dernier tick, ordre de la flotte
+    std::vector<int> woken;             // réveils du tick
+    int activeCars = -1;                // taille de flotte pour laquelle active / parkedWheel sont à jour
+    uint64_t fleetEdits = 0;            // modifications de la flotte hors du tick (NoteFleetEdit)
+    uint64_t fleetEditsSeen = 0;        // ... déjà rapprochées de parkedWheel
+    ThreadPool pool;
+    SimClock clock;
+    TrajectoryRecorder* recorder = nullptr;   // si présent, reçoit l'état de la flotte à chaque tick
+};
+
+// Met l'index des voies à jour avec la flotte : seules les voitures traitées au dernier
+// tick sont relues (toutes si la flotte a changé de taille)
+void SyncLaneIndex(const std::vector<Car>& cars, const std::vector<Road>& roads, TrafficState& state);
+
+// Signale une modification de la flotte hors du tick (voitures éditées sur place) : le tick
+// suivant relit toute la flotte et réveille les voitures endormies qui ont changé
+void NoteFleetEdit(TrafficState& state);
+
+// Vérifie si la voie est libre (pour changement de voie)
+bool IsLaneFree(const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myId);
+
+// Idem en O(log n) grâce à l'index des voies (myIdx : indice de la voiture dans la flotte)
+bool IsLaneFree(const LaneIndex& index, const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myIdx);
+
+// Mise à jour complète du trafic automobile, y compris parkings.
+// Tick en trois temps : perception (lecture seule), décision/action dans le tampon
+// arrière (en parallèle), puis application en série des actions sur les parkings.
+void UpdateTraffic(std::vector<Car>& cars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                   float dt, TrafficState& state);
+
+// Avance la simulation de frameDt secondes de temps simulé (temps réel x échelle de temps)
+// par pas fixes. Au-delà de clock.maxStepsPerFrame pas, le reste est abandonné.
+// Renvoie le nombre de pas fixes exécutés.
+int StepSimulation(std::vector<Car>& cars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                   float frameDt, TrafficState& state);
+
+// Simule seconds secondes aussi vite que possible (sans limite de pas), avec
+// exactement les mêmes pas fixes que StepSimulation. Renvoie le nombre de pas exécutés.
+int64_t RunSimulation(std::vector<Car>& cars, std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                      double seconds, TrafficState& state);
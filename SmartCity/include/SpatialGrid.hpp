@@ -0,0 +1,57 @@
+#pragma once
+#include "SimMath.hpp"
+#include <cstdint>
+#include <vector>
+
+// Boîte englobante alignée sur les axes (coordonnées monde)
+struct Bounds {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+
+    bool overlaps(const Bounds& o) const {
+        return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+    }
+    bool contains(Vec2 p) const { return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY; }
+    Bounds grown(float margin) const { return { minX - margin, minY - margin, maxX + margin, maxY + margin }; }
+};
+
+// Grille uniforme d'objets statiques (routes, parkings) pour trouver ceux qui
+// chevauchent une zone (la vue) sans parcourir tout le monde.
+// Cellules en CSR : les indices d'objets de chaque cellule sont contigus.
+// Un objet est rangé dans toutes les cellules que couvre sa boîte.
+class SpatialGrid {
+public:
+    // Reconstruit la grille (cellSize <= 0 : DEFAULT_CELL_SIZE). La taille est agrandie
+    // si besoin pour rester sous MAX_CELLS_PER_AXIS cellules par axe.
+    void build(const std::vector<Bounds>& boxes, float cellSize = 0.0f);
+
+    // Indices (croissants, sans doublon) des objets dont la boîte chevauche zone
+    void query(const Bounds& zone, std::vector<int>& out) const;
+
+    size_t size() const { return boxes.size(); }
+    const Bounds& bounds(int idx) const { return boxes[idx]; }
+    const Bounds& extent() const { return worldExtent; }
+
+    static constexpr float DEFAULT_CELL_SIZE = 256.0f;
+    static constexpr int MAX_CELLS_PER_AXIS = 256;
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    std::vector<Bounds> boxes;
+    Bounds worldExtent = {0, 0, 0, 0};
+    float cell = 1.0f;
+    int cols = 0;
+    int rows = 0;
+    std::vector<int> cellStart;     // cols*rows + 1 bornes dans items
+    std::vector<int> items;
+    mutable std::vector<uint32_t> stamp;   // dernière requête ayant vu l'objet (dédoublonnage)
+    mutable uint32_t queryStamp = 0;
+};
+
+// Découpe le segment [a, b] par la boîte (Liang-Barsky) : [t0, t1] est la portion
+// visible en paramètre (0 = a, 1 = b). false si le segment est entièrement dehors.
+bool ClipSegment(Vec2 a, Vec2 b, const Bounds& box, float& t0, float& t1);
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Occupation des places d'un parking : bitmap 64 bits à plusieurs niveaux.
+//  - niveau 0 : un bit par place (1 = occupée)
+//  - niveau k+1 : un bit par mot du niveau k (1 = mot entièrement occupé)
+// La première place libre se trouve en descendant les niveaux avec ctz,
+// soit O(log64 n) (2 niveaux jusqu'à 4096 places, 3 jusqu'à 262144).
+// Les bits au-delà de la capacité sont marqués occupés pour n'être jamais trouvés.
+class SpotBitmap {
+public:
+    SpotBitmap() {}
+    explicit SpotBitmap(int capacity) { resize(capacity); }
+
+    // Redimensionne et libère toutes les places
+    void resize(int capacity);
+
+    bool test(int idx) const {
+        return (levels[0][idx >> 6] >> (idx & 63)) & 1u;
+    }
+    // Marque la place occupée / libre (sans effet si elle l'est déjà)
+    void set(int idx);
+    void reset(int idx);
+
+    // Première place libre, -1 si le parking est plein
+    int findFirstFree() const;
+
+    int size() const { return capacity; }
+    int count() const { return occupied; }
+    bool full() const { return occupied >= capacity; }
+
+private:
+    std::vector<std::vector<uint64_t>> levels;
+    int capacity = 0;
+    int occupied = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads minimal pour les boucles "parallel for" de la simulation.
+// Le thread appelant participe au travail; avec 1 thread tout s'exécute en ligne.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount = 1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)workers.size() + 1; }
+
+    // Appelle fn(begin, end) sur des tranches disjointes de [0, count) et attend la fin.
+    // fn ne doit écrire que dans les éléments de sa tranche.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0;
+    size_t jobGrain = 1;
+    std::atomic<size_t> nextChunk{0};
+    int busyWorkers = 0;
+    unsigned generation = 0;
+    bool stopping = false;
+};
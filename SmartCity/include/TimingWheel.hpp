@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------
+//  Roue temporelle hiérarchique
+// ---------------------------
+//
+// Échéancier des voitures garées : une voiture endormie n'est plus parcourue à chaque tick,
+// elle attend dans la case de son heure de réveil. Le temps est découpé en cases de
+// WHEEL_RESOLUTION secondes ; la roue fine couvre WHEEL_SLOTS cases, la roue grossière
+// WHEEL_SLOTS tours de la roue fine, et les échéances plus lointaines attendent dans une
+// liste relue à chaque tour de la roue grossière. Programmer est en O(1) ; avancer ne
+// coûte que les cases franchies et les entrées qui en sortent (une entrée descend au plus
+// deux fois de roue avant de mûrir).
+
+const double WHEEL_RESOLUTION = 1.0 / 16.0;   // s
+const int WHEEL_BITS = 8;
+const int WHEEL_SLOTS = 1 << WHEEL_BITS;
+
+class TimingWheel {
+public:
+    // Vide la roue pour count ids, l'horloge reprenant à now
+    void clear(int count, double now);
+
+    // Réveil de id à l'heure when (une échéance passée mûrit à la prochaine avance). Un id déjà
+    // programmé est reprogrammé : l'ancienne entrée, périmée, est écartée quand la roue la relit.
+    void schedule(int id, double when);
+    // Annule le réveil de id (son entrée, périmée, est écartée quand la roue la relit)
+    void cancel(int id);
+
+    // Avance l'horloge jusqu'à now et ajoute à due les ids mûrs (échéance <= now), sans ordre
+    void advance(double now, std::vector<int>& due);
+
+    double now() const { return time; }
+    bool scheduled(int id) const { return deadline[id] >= 0.0; }
+    double deadlineOf(int id) const { return deadline[id]; }
+    size_t size() const { return pending; }
+
+private:
+    struct Entry {
+        int id;
+        double when;
+    };
+
+    int64_t slotOf(double t) const;
+    void place(const Entry& e);
+    void cascade(std::vector<Entry>& bucket);
+    // Entrée encore valable : l'échéance de son id n'a été ni rendue ni reprogrammée
+    bool live(const Entry& e) const { return deadline[e.id] == e.when; }
+
+    std::vector<Entry> fine[WHEEL_SLOTS];
+    std::vector<Entry> coarse[WHEEL_SLOTS];
+    std::vector<Entry> overflow;
+    std::vector<Entry> scratch;
+    std::vector<double> deadline;   // par id, -1 si non programmé
+    int64_t cursor = 0;             // case de l'horloge
+    double time = 0.0;
+    size_t pending = 0;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------
+//  Traces d'exécution (format Chrome / Perfetto)
+// ---------------------------
+//
+// TRACE_SCOPE("nom") enregistre la durée de la portée dans un tampon propre au thread
+// (aucun partage entre threads pendant la mesure) ; WriteChromeTrace exporte ensuite tous
+// les tampons en JSON "Trace Event", lisible dans chrome://tracing ou ui.perfetto.dev :
+// une ligne par thread (simulation, pool, rendu), ce qui montre attentes et chevauchements.
+// Les macros ne coûtent rien tant que SMARTCITY_TRACE n'est pas défini (option CMake
+// SMARTCITY_TRACE) : elles disparaissent à la compilation. Le nom doit être une chaîne
+// littérale (seul le pointeur est gardé).
+
+// Événements gardés par thread (les plus anciens sont écrasés au-delà)
+const size_t TRACE_BUFFER_EVENTS = 1 << 16;
+
+// Horloge des traces (ns depuis le premier appel)
+uint64_t TraceNow();
+// Ajoute un événement [start, end] au tampon du thread courant
+void TraceRecord(const char* name, uint64_t start, uint64_t end);
+// Nom du thread courant dans la trace
+void TraceThreadName(const char* name);
+
+// Export JSON de tous les tampons (threads terminés compris)
+bool WriteChromeTrace(const std::string& path, std::string& error);
+// Événements en mémoire, tous threads confondus
+size_t TraceEventCount();
+// Vide les tampons (les threads gardent leur nom)
+void ClearTrace();
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start(TraceNow()) {}
+    ~TraceScope() { TraceRecord(name, start, TraceNow()); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef SMARTCITY_TRACE
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_THREAD(name) TraceThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#endif
@@ -1,10 +1,16 @@
-#pragma once
-#include "raylib.h"
-#include "Components.hpp"   // Pour ParkingLot, Road
-#include "Simulation.hpp"   
-
-// Dessine une ligne pointillée entre deux points
-void DrawDashedLine(Vector2 start, Vector2 end, float thickness, Color color);
-
-// Dessine l’allée d’accès du parking à la route principale
-void DrawDriveway(const struct ParkingLot& p, const struct Road& r);
\ No newline at end of file
+#pragma once
+#include "raylib.h"
+#include "Components.hpp"   // Pour ParkingLot, Road
+#include "Simulation.hpp"   
+
+// Conversions entre les types du coeur de simulation et ceux de raylib
+inline Vector2 ToVector2(Vec2 v) { return { v.x, v.y }; }
+inline Vec2 ToVec2(Vector2 v) { return { v.x, v.y }; }
+inline Color ToColor(Rgba c) { return { c.r, c.g, c.b, c.a }; }
+inline Rgba ToRgba(Color c) { return { c.r, c.g, c.b, c.a }; }
+
+// Dessine une ligne pointillée entre deux points
+void DrawDashedLine(Vector2 start, Vector2 end, float thickness, Color color);
+
+// Dessine l’allée d’accès du parking à la route principale
+void DrawDriveway(const struct ParkingLot& p, const struct Road& r);
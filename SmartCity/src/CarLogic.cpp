@@ -1,57 +1,192 @@
-#include "../include/CarLogic.hpp"
-#include "raylib.h"
-#include "raymath.h"
-#include <cmath>
-void DrawCar(const Car& car, const Road& road) {
-    Vector2 pos;
-    float angle;
-//logic de position de la voiture driving ou stationnement 
-    if (car.state == DRIVING) {
-        Vector2 dir = road.getDir();
-        Vector2 normal = { -dir.y, dir.x };
-        Vector2 centerPos = Vector2Add(road.start, Vector2Scale(dir, car.distance));
-        pos = Vector2Add(centerPos, Vector2Scale(normal, car.laneOffset));
-        angle = atan2(dir.y, dir.x) * RAD2DEG;
-    } else {
-        pos = car.worldPos;
-        
-        angle = car.rotation;
-    }
-
-    // --- PARAMETRES ---
-    float length = 38.0f;
-    float width = 20.0f;
-    float rad = angle * DEG2RAD;
-    Color bodyColor = car.color;
-
-    // 1. LES ROUE
-    float wheelW = 8.0f; float wheelH = 4.0f;
-    Vector2 wheelOffsets[4] = { {12,-9}, {12,9}, {-12,-9}, {-12,9} };
-    for(int i=0; i<4; i++) {
-        Rectangle wRec = { pos.x, pos.y, wheelW, wheelH };
-        DrawRectanglePro(wRec, { -wheelOffsets[i].x + wheelW/2, -wheelOffsets[i].y + wheelH/2 }, angle, BLACK);
-    }
-
-    // 2. CORPS 
-    Rectangle body = { pos.x, pos.y, length, width };
-    DrawRectanglePro(body, { length/2, width/2 }, angle, bodyColor);
-    
-    // CONTOUR 
-    
-    DrawPolyLinesEx(pos, 4, length/1.8f, angle + 45, 2, Fade(BLACK, 0.4f));
-
-    // 3. Windows/Glass
-    Rectangle glass = { pos.x, pos.y, length * 0.45f, width * 0.75f };
-    DrawRectanglePro(glass, { (length * 0.45f)/2 - 3, (width * 0.75f)/2 }, angle, GetColor(0x222222FF));
-
-    // 4. PHARES AVANT (Yellow)
-    Vector2 front = { pos.x + cosf(rad) * (length/2), pos.y + sinf(rad) * (length/2) };
-    Vector2 side = { -sinf(rad) * (width/3), cosf(rad) * (width/3) };
-    DrawCircleV(Vector2Add(front, side), 3, YELLOW);
-    DrawCircleV(Vector2Subtract(front, side), 3, YELLOW);
-
-    // 5. FEUX ARRIÈRE (Red)
-    Vector2 back = { pos.x - cosf(rad) * (length/2), pos.y - sinf(rad) * (length/2) };
-    DrawCircleV(Vector2Add(back, side), 2, RED);
-    DrawCircleV(Vector2Subtract(back, side), 2, RED);
-}
+#include "../include/CarLogic.hpp"
+#include "../include/Utils.hpp"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ---------------------------
+//  Modèle de voiture
+// ---------------------------
+// Formes de la voiture dans son repère local (x vers l'avant, y vers la droite), dans
+// l'ordre de dessin : 4 roues, carrosserie, contour, vitre, phares, feux arrière.
+// Toutes sont des quadrilatères : la voiture entière tient dans un seul rlBegin(RL_QUADS).
+struct CarQuad {
+    Vector2 corners[4];     // sens haut-gauche, bas-gauche, bas-droite, haut-droite (comme rlgl)
+    Color color;
+    bool bodyColor;         // couleur de la voiture plutôt que color
+};
+
+const float CAR_DRAW_LENGTH = 38.0f;
+const float CAR_DRAW_WIDTH = 20.0f;
+const int QUADS_PER_CAR = 14;
+// Voitures par rlBegin : 128 x 56 sommets tiennent dans un lot rlgl par défaut (8192 quads)
+const int CARS_PER_SUBMIT = 128;
+
+static CarQuad RectQuad(float x0, float y0, float x1, float y1, Color color, bool bodyColor = false) {
+    return { { {x0, y0}, {x0, y1}, {x1, y1}, {x1, y0} }, color, bodyColor };
+}
+
+static std::vector<CarQuad> BuildCarModel() {
+    const float length = CAR_DRAW_LENGTH;
+    const float width = CAR_DRAW_WIDTH;
+    std::vector<CarQuad> model;
+
+    // 1. Roues
+    const float wheelW = 8.0f, wheelH = 4.0f;
+    const Vector2 wheelOffsets[4] = { {12,-9}, {12,9}, {-12,-9}, {-12,9} };
+    for (const Vector2& w : wheelOffsets)
+        model.push_back(RectQuad(w.x - wheelW/2, w.y - wheelH/2, w.x + wheelW/2, w.y + wheelH/2, BLACK));
+
+    // 2. Carrosserie
+    model.push_back(RectQuad(-length/2, -width/2, length/2, width/2, WHITE, true));
+
+    // Contour : carré tourné de 45° (rayon length/1.8, épaisseur 2), un quad par côté
+    const float outer = length / 1.8f, inner = outer - 2.0f;
+    for (int k = 0; k < 4; k++) {
+        float a0 = (45.0f + 90.0f * k) * DEG2RAD, a1 = (45.0f + 90.0f * (k + 1)) * DEG2RAD;
+        CarQuad side;
+        side.corners[0] = { outer * cosf(a0), outer * sinf(a0) };
+        side.corners[1] = { inner * cosf(a0), inner * sinf(a0) };
+        side.corners[2] = { inner * cosf(a1), inner * sinf(a1) };
+        side.corners[3] = { outer * cosf(a1), outer * sinf(a1) };
+        side.color = Fade(BLACK, 0.4f);
+        side.bodyColor = false;
+        model.push_back(side);
+    }
+
+    // 3. Vitre
+    const float glassW = length * 0.45f, glassH = width * 0.75f;
+    model.push_back(RectQuad(-glassW/2 + 3, -glassH/2, glassW/2 + 3, glassH/2, GetColor(0x222222FF)));
+
+    // 4. Phares avant et 5. feux arrière : carrés de même aire que les disques d'origine
+    const float lightSide = width / 3;
+    const float head = 3.0f * 0.886f, tail = 2.0f * 0.886f;
+    for (float s : { lightSide, -lightSide })
+        model.push_back(RectQuad(length/2 - head, s - head, length/2 + head, s + head, YELLOW));
+    for (float s : { lightSide, -lightSide })
+        model.push_back(RectQuad(-length/2 - tail, s - tail, -length/2 + tail, s + tail, RED));
+
+    return model;
+}
+
+static const std::vector<CarQuad>& CarModel() {
+    static const std::vector<CarQuad> model = BuildCarModel();
+    return model;
+}
+
+// ---------------------------
+//  Émission des sommets
+// ---------------------------
+// Position et orientation (cos, sin) d'une voiture
+struct CarPose {
+    Vector2 pos;
+    float cosA;
+    float sinA;
+};
+
+// Sur la route : position recalculée depuis la distance, orientation de la route (dir = (cos, sin))
+static CarPose PoseOnRoad(const Car& car, Vector2 start, Vector2 dir) {
+    Vector2 normal = { -dir.y, dir.x };
+    Vector2 centerPos = Vector2Add(start, Vector2Scale(dir, car.distance));
+    return { Vector2Add(centerPos, Vector2Scale(normal, car.laneOffset)), dir.x, dir.y };
+}
+
+static CarPose PoseOf(const Car& car, Vector2 roadStart, Vector2 roadDir) {
+    if (car.state == DRIVING) return PoseOnRoad(car, roadStart, roadDir);
+    float rad = car.rotation * DEG2RAD;
+    return { ToVector2(car.worldPos), cosf(rad), sinf(rad) };
+}
+
+// À appeler entre rlBegin(RL_QUADS) et rlEnd()
+static void EmitCar(const Car& car, const CarPose& pose) {
+    const Color body = ToColor(car.color);
+    for (const CarQuad& q : CarModel()) {
+        const Color& c = q.bodyColor ? body : q.color;
+        rlColor4ub(c.r, c.g, c.b, c.a);
+        for (const Vector2& p : q.corners) {
+            rlVertex2f(pose.pos.x + p.x * pose.cosA - p.y * pose.sinA,
+                       pose.pos.y + p.x * pose.sinA + p.y * pose.cosA);
+        }
+    }
+}
+
+void DrawCar(const Car& car, const Road& road) {
+    CarPose pose = PoseOf(car, ToVector2(road.start), ToVector2(road.getDir()));
+    rlCheckRenderBatchLimit(QUADS_PER_CAR * 4);
+    rlSetTexture(rlGetTextureIdDefault());
+    rlBegin(RL_QUADS);
+    EmitCar(car, pose);
+    rlEnd();
+    rlSetTexture(0);
+}
+
+// Niveau de détail réduit : la carrosserie seule (un quad orienté), ou un carré de
+// côté pointSize aligné sur les axes (quelques pixels à l'écran, orientation inutile)
+static void EmitCarLod(const Car& car, const CarPose& pose, CarDetail detail, float pointSize) {
+    const Color c = ToColor(car.color);
+    rlColor4ub(c.r, c.g, c.b, c.a);
+    if (detail == CAR_DETAIL_POINT) {
+        const float h = pointSize / 2;
+        rlVertex2f(pose.pos.x - h, pose.pos.y - h);
+        rlVertex2f(pose.pos.x - h, pose.pos.y + h);
+        rlVertex2f(pose.pos.x + h, pose.pos.y + h);
+        rlVertex2f(pose.pos.x + h, pose.pos.y - h);
+        return;
+    }
+    const float hl = CAR_DRAW_LENGTH / 2, hw = CAR_DRAW_WIDTH / 2;
+    const float corners[4][2] = { {-hl, -hw}, {-hl, hw}, {hl, hw}, {hl, -hw} };
+    for (const auto& p : corners) {
+        rlVertex2f(pose.pos.x + p[0] * pose.cosA - p[1] * pose.sinA,
+                   pose.pos.y + p[0] * pose.sinA + p[1] * pose.cosA);
+    }
+}
+
+// Soumet count voitures : poseAt(k) donne l'indice dans la flotte de la k-ième et sa pose
+template <typename PoseAt>
+static void SubmitCars(const std::vector<Car>& cars, size_t count, PoseAt poseAt, CarDetail detail, float pointSize) {
+    // Les sommets s'accumulent dans le lot rlgl courant : un appel de dessin par lot plein
+    const int quads = (detail == CAR_DETAIL_FULL) ? QUADS_PER_CAR : 1;
+    const size_t perSubmit = (size_t)(CARS_PER_SUBMIT * QUADS_PER_CAR / quads);
+    for (size_t first = 0; first < count; first += perSubmit) {
+        size_t last = std::min(count, first + perSubmit);
+        rlCheckRenderBatchLimit((int)(last - first) * quads * 4);
+        rlSetTexture(rlGetTextureIdDefault());
+        rlBegin(RL_QUADS);
+        for (size_t k = first; k < last; k++) {
+            CarPose pose;
+            const Car& car = cars[poseAt(k, pose)];
+            if (detail == CAR_DETAIL_FULL) EmitCar(car, pose);
+            else EmitCarLod(car, pose, detail, pointSize);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
+
+void DrawCars(const std::vector<Car>& cars, const std::vector<Road>& roads) {
+    // Orientation de chaque route, calculée une fois par trame (et non par voiture)
+    static std::vector<Vector2> roadStart, roadDir;
+    roadStart.resize(roads.size());
+    roadDir.resize(roads.size());
+    for (size_t r = 0; r < roads.size(); r++) {
+        roadStart[r] = ToVector2(roads[r].start);
+        roadDir[r] = ToVector2(roads[r].getDir());
+    }
+    SubmitCars(cars, cars.size(), [&](size_t k, CarPose& pose) {
+        int r = cars[k].roadIndex;
+        pose = PoseOf(cars[k], roadStart[r], roadDir[r]);
+        return k;
+    }, CAR_DETAIL_FULL, 0.0f);
+}
+
+void DrawCars(const std::vector<Car>& cars, const std::vector<int>& visible, const std::vector<Vec2>& pos,
+              const std::vector<float>& angle, CarDetail detail, float pointSize) {
+    SubmitCars(cars, visible.size(), [&](size_t k, CarPose& pose) {
+        float rad = angle[k] * DEG2RAD;
+        pose = { ToVector2(pos[k]), cosf(rad), sinf(rad) };
+        return (size_t)visible[k];
+    }, detail, pointSize);
+}
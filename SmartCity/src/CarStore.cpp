@@ -0,0 +1,143 @@
+#include "../include/CarStore.hpp"
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SMARTCITY_SSE2 1
+#endif
+
+void CarStore::resizeHot(size_t n) {
+    distance.resize(n);
+    speed.resize(n);
+    laneOffset.resize(n);
+    state.resize(n);
+    targetSpeed.resize(n);
+    blend.resize(n);
+    speedCap.resize(n);
+}
+
+void CarStore::clear() {
+    resizeHot(0);
+    cold.clear();
+}
+
+// Par défaut la vitesse est conservée telle quelle
+void CarStore::loadCar(size_t i, const Car& car) {
+    distance[i] = car.distance;
+    speed[i] = car.speed;
+    laneOffset[i] = car.laneOffset;
+    state[i] = car.state;
+    targetSpeed[i] = car.speed;
+    blend[i] = 0.0f;
+    speedCap[i] = std::numeric_limits<float>::max();
+}
+
+void CarStore::loadHot(const std::vector<Car>& cars) {
+    resizeHot(cars.size());
+    for (size_t i = 0; i < cars.size(); i++) loadCar(i, cars[i]);
+}
+
+void CarStore::loadHot(const std::vector<Car>& cars, const std::vector<int>& only) {
+    resizeHot(cars.size());
+    for (int i : only) loadCar(i, cars[i]);
+}
+
+void CarStore::assign(const std::vector<Car>& cars) {
+    loadHot(cars);
+    cold = cars;
+}
+
+void CarStore::copyTo(std::vector<Car>& cars) const {
+    cars.resize(size());
+    for (size_t i = 0; i < size(); i++) cars[i] = get(i);
+}
+
+void CarStore::push_back(const Car& car) {
+    resizeHot(size() + 1);
+    cold.push_back(car);
+    set(size() - 1, car);
+}
+
+Car CarStore::get(size_t i) const {
+    Car car = cold[i];
+    car.distance = distance[i];
+    car.speed = speed[i];
+    car.laneOffset = laneOffset[i];
+    car.state = (CarState)state[i];
+    return car;
+}
+
+void CarStore::set(size_t i, const Car& car) {
+    cold[i] = car;
+    distance[i] = car.distance;
+    speed[i] = car.speed;
+    laneOffset[i] = car.laneOffset;
+    state[i] = car.state;
+    targetSpeed[i] = car.speed;
+    blend[i] = 0.0f;
+    speedCap[i] = std::numeric_limits<float>::max();
+}
+
+void IntegrateKinematics(CarStore& store, float dt) {
+    IntegrateKinematics(store, dt, 0, store.size());
+}
+
+void IntegrateKinematics(CarStore& store, float dt, size_t begin, size_t end) {
+    const size_t n = std::min(end, store.size());
+    float* distance = store.distance.data();
+    float* speed = store.speed.data();
+    const float* target = store.targetSpeed.data();
+    const float* blend = store.blend.data();
+    const float* cap = store.speedCap.data();
+    const int32_t* state = store.state.data();
+    size_t i = begin;
+
+#if defined(__AVX2__)
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256i driving = _mm256_set1_epi32(DRIVING);
+    for (; i + 8 <= n; i += 8) {
+        __m256 s = _mm256_loadu_ps(speed + i);
+        __m256 d = _mm256_loadu_ps(distance + i);
+        __m256 mask = _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(state + i)), driving));
+
+        __m256 ns = _mm256_add_ps(s, _mm256_mul_ps(_mm256_loadu_ps(blend + i),
+                                                   _mm256_sub_ps(_mm256_loadu_ps(target + i), s)));
+        ns = _mm256_min_ps(ns, _mm256_loadu_ps(cap + i));
+        __m256 nd = _mm256_add_ps(d, _mm256_mul_ps(ns, vdt));
+
+        _mm256_storeu_ps(speed + i, _mm256_blendv_ps(s, ns, mask));
+        _mm256_storeu_ps(distance + i, _mm256_blendv_ps(d, nd, mask));
+    }
+#elif defined(SMARTCITY_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128i driving = _mm_set1_epi32(DRIVING);
+    for (; i + 4 <= n; i += 4) {
+        __m128 s = _mm_loadu_ps(speed + i);
+        __m128 d = _mm_loadu_ps(distance + i);
+        __m128 mask = _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(state + i)), driving));
+
+        __m128 ns = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(blend + i),
+                                             _mm_sub_ps(_mm_loadu_ps(target + i), s)));
+        ns = _mm_min_ps(ns, _mm_loadu_ps(cap + i));
+        __m128 nd = _mm_add_ps(d, _mm_mul_ps(ns, vdt));
+
+        // Sélection sans blendv (SSE2) : (mask & nouveau) | (~mask & ancien)
+        _mm_storeu_ps(speed + i, _mm_or_ps(_mm_and_ps(mask, ns), _mm_andnot_ps(mask, s)));
+        _mm_storeu_ps(distance + i, _mm_or_ps(_mm_and_ps(mask, nd), _mm_andnot_ps(mask, d)));
+    }
+#endif
+
+    // Reste (ou plateforme sans SIMD) : même formule en scalaire
+    for (; i < n; i++) {
+        if (state[i] != DRIVING) continue;
+        float s = LerpF(speed[i], target[i], blend[i]);
+        s = std::min(s, cap[i]);
+        speed[i] = s;
+        distance[i] += s * dt;
+    }
+}
@@ -0,0 +1,334 @@
+#include "../include/Checkpoint.hpp"
+#include "../include/ParkingLogic.hpp"
+#include "../include/Random.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+static_assert(std::is_trivially_copyable<Car>::value, "Car est stockee telle quelle dans les points de reprise");
+
+const uint32_t CHECKPOINT_ENDIAN_TAG = 0x01020304u;
+
+// ---------------------------
+//  Lecture / écriture brute
+// ---------------------------
+template <typename T>
+static void Put(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* bytes = (const uint8_t*)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void PutBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+struct CheckpointCursor {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+
+    bool take(void* dst, size_t n) {
+        if (n > size - pos) return false;
+        if (n) std::memcpy(dst, data + pos, n);   // dst nul pour un tableau vide
+        pos += n;
+        return true;
+    }
+    template <typename T>
+    bool get(T& value) { return take(&value, sizeof(T)); }
+};
+
+// FNV-1a 64 bits
+static void HashBytes(uint64_t& h, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= 0x100000001B3ull;
+    }
+}
+
+uint64_t LayoutHash(const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const Road& r : roads) {
+        HashBytes(h, &r.start, sizeof(r.start));
+        HashBytes(h, &r.end, sizeof(r.end));
+        HashBytes(h, &r.lanes, sizeof(r.lanes));
+        HashBytes(h, &r.width, sizeof(r.width));
+        HashBytes(h, &r.next, sizeof(r.next));
+        HashBytes(h, &r.signal, sizeof(r.signal));
+    }
+    for (const ParkingLot& p : parkings) {
+        HashBytes(h, &p.position, sizeof(p.position));
+        HashBytes(h, &p.size, sizeof(p.size));
+        HashBytes(h, &p.capacity, sizeof(p.capacity));
+        HashBytes(h, &p.exitPos, sizeof(p.exitPos));
+        HashBytes(h, &p.roadIndex, sizeof(p.roadIndex));
+        HashBytes(h, &p.lane, sizeof(p.lane));
+    }
+    return h;
+}
+
+// ---------------------------
+//  Écriture
+// ---------------------------
+void WriteCheckpoint(std::vector<uint8_t>& out, const std::vector<Car>& cars, const std::vector<Road>& roads,
+                     const std::vector<ParkingLot>& parkings, const TrafficState& state) {
+    CheckpointHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic));
+    h.version = CHECKPOINT_VERSION;
+    h.endianTag = CHECKPOINT_ENDIAN_TAG;
+    h.carSize = sizeof(Car);
+    h.roadCount = (uint32_t)roads.size();
+    h.lotCount = (uint32_t)parkings.size();
+    h.carCount = cars.size();
+    h.layoutHash = LayoutHash(roads, parkings);
+    h.seed = state.seed;
+    h.tick = state.tick;
+    h.simRngState = SimRng().state;
+    h.fixedDt = state.clock.fixedDt;
+    h.substeps = state.clock.substeps;
+    h.accumulator = state.clock.accumulator;
+    h.time = state.clock.time;
+    h.clockTick = state.clock.tick;
+    h.droppedTime = state.clock.droppedTime;
+
+    out.clear();
+    out.reserve(sizeof(h) + roads.size() * 8 + cars.size() * sizeof(Car) + parkings.size() * 64);
+    Put(out, h);
+
+    // Feux
+    for (const Road& r : roads) {
+        Put(out, (int32_t)r.light.state);
+        Put(out, r.light.timer);
+    }
+    // Contrôleur des feux (rien s'il n'a pas encore été construit) : temps, début du cycle
+    // de chaque carrefour, phase de chaque feu
+    const SignalController& signals = state.signals;
+    Put(out, signals.now());
+    Put(out, (uint32_t)signals.getJunctions().size());
+    Put(out, (uint32_t)signals.getHeads().size());
+    for (const SignalJunction& j : signals.getJunctions()) Put(out, j.cycleStart);
+    for (const SignalHead& head : signals.getHeads()) {
+        Put(out, head.greenStart);
+        Put(out, head.greenTime);
+        Put(out, (int32_t)head.queue);
+        Put(out, head.nextSwitch);
+    }
+    // Voitures garées endormies : horloge de la roue et échéance de chacune (l'attente
+    // décomptée dans leur waitTimer s'est arrêtée à l'endormissement)
+    const TimingWheel& wheel = state.parkedWheel;
+    const bool wheelValid = state.activeCars == (int)cars.size();
+    Put(out, wheel.now());
+    Put(out, (uint32_t)(wheelValid ? wheel.size() : 0));
+    for (int i = 0; wheelValid && i < (int)cars.size(); i++) {
+        if (!wheel.scheduled(i)) continue;
+        Put(out, (int32_t)i);
+        Put(out, wheel.deadlineOf(i));
+    }
+    // Tarifs (rien s'ils n'ont pas encore été construits) : temps, prochaine révision, puis
+    // prix de base, prix courant, occupation et tendance de chaque parking
+    const PricingEngine& pricing = state.pricing;
+    const bool pricingValid = pricing.matches(parkings);
+    Put(out, pricing.now());
+    Put(out, pricing.nextRevision());
+    Put(out, (uint32_t)(pricingValid ? parkings.size() : 0));
+    if (pricingValid) {
+        const LotPrices& lots = pricing.getLots();
+        for (const std::vector<float>* field : {&lots.base, &lots.price, &lots.occupancy, &lots.trend})
+            PutBytes(out, field->data(), field->size() * sizeof(float));
+    }
+
+    // Parkings : occupation (un bit par place, mots de 64 bits) puis registre dans son ordre
+    for (const ParkingLot& p : parkings) {
+        for (int w = 0; w < (p.capacity + 63) / 64; w++) {
+            uint64_t word = 0;
+            for (int b = 0; b < 64 && w * 64 + b < p.capacity; b++) {
+                if (p.isOccupied(w * 64 + b)) word |= 1ull << b;
+            }
+            Put(out, word);
+        }
+        for (const std::vector<int>* list : {&p.entering, &p.parked, &p.leaving}) {
+            Put(out, (uint32_t)list->size());
+            PutBytes(out, list->data(), list->size() * sizeof(int));
+        }
+    }
+
+    PutBytes(out, cars.data(), cars.size() * sizeof(Car));
+}
+
+// ---------------------------
+//  Lecture
+// ---------------------------
+bool ReadCheckpoint(const uint8_t* data, size_t size, std::vector<Car>& cars, std::vector<Road>& roads,
+                    std::vector<ParkingLot>& parkings, TrafficState& state, std::string& error) {
+    CheckpointCursor in = {data, size};
+    CheckpointHeader h;
+    if (!in.get(h) || std::memcmp(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic)) != 0) {
+        error = "pas un point de reprise";
+        return false;
+    }
+    if (h.version != CHECKPOINT_VERSION || h.endianTag != CHECKPOINT_ENDIAN_TAG || h.carSize != sizeof(Car)) {
+        error = "version, boutisme ou disposition des voitures non supportes";
+        return false;
+    }
+    if (h.roadCount != roads.size() || h.lotCount != parkings.size() || h.layoutHash != LayoutHash(roads, parkings)) {
+        error = "point de reprise d'un autre scenario (routes ou parkings differents)";
+        return false;
+    }
+    if (h.carCount > (size - in.pos) / sizeof(Car)) {
+        error = "point de reprise tronque";
+        return false;
+    }
+
+    // Décodage complet dans des copies : l'état courant reste intact en cas d'erreur
+    std::vector<Road> newRoads = roads;
+    std::vector<ParkingLot> newParkings = parkings;
+    bool ok = true;
+    for (Road& r : newRoads) {
+        int32_t light;
+        ok = ok && in.get(light) && in.get(r.light.timer) && light >= LIGHT_GREEN && light <= LIGHT_RED;
+        if (ok) r.light.state = (LightState)light;
+    }
+    double signalTime = 0.0;
+    uint32_t junctionCount = 0, headCount = 0;
+    ok = ok && in.get(signalTime) && in.get(junctionCount) && in.get(headCount) &&
+         (headCount == 0 || headCount == roads.size()) && junctionCount <= headCount;
+    std::vector<double> cycleStarts(ok ? junctionCount : 0);
+    for (double& start : cycleStarts) ok = ok && in.get(start);
+    std::vector<SignalHead> savedHeads(ok ? headCount : 0);
+    for (SignalHead& head : savedHeads) {
+        int32_t queue = 0;
+        ok = ok && in.get(head.greenStart) && in.get(head.greenTime) && in.get(queue) && in.get(head.nextSwitch);
+        head.queue = queue;
+    }
+    double wheelTime = 0.0;
+    uint32_t sleeperCount = 0;
+    ok = ok && in.get(wheelTime) && in.get(sleeperCount) && sleeperCount <= h.carCount;
+    std::vector<std::pair<int32_t, double>> sleepers(ok ? sleeperCount : 0);
+    for (auto& sleeper : sleepers) {
+        ok = ok && in.get(sleeper.first) && in.get(sleeper.second) &&
+             sleeper.first >= 0 && (uint64_t)sleeper.first < h.carCount;
+    }
+    double pricingTime = 0.0, pricingNext = 0.0;
+    uint32_t pricedLots = 0;
+    ok = ok && in.get(pricingTime) && in.get(pricingNext) && in.get(pricedLots) &&
+         (pricedLots == 0 || pricedLots == parkings.size());
+    LotPrices savedPrices;
+    for (std::vector<float>* field : {&savedPrices.base, &savedPrices.price, &savedPrices.occupancy, &savedPrices.trend}) {
+        field->resize(ok ? pricedLots : 0);
+        ok = ok && in.take(field->data(), field->size() * sizeof(float));
+    }
+    for (ParkingLot& p : newParkings) {
+        if (!ok) break;
+        p.spotsOccupied.resize(p.capacity);
+        for (int w = 0; ok && w < (p.capacity + 63) / 64; w++) {
+            uint64_t word;
+            ok = in.get(word);
+            for (int b = 0; ok && b < 64 && w * 64 + b < p.capacity; b++) {
+                if ((word >> b) & 1u) p.occupySpot(w * 64 + b);
+            }
+        }
+        for (std::vector<int>* list : {&p.entering, &p.parked, &p.leaving}) {
+            uint32_t count = 0;
+            ok = ok && in.get(count) && count <= h.carCount && count <= (size - in.pos) / sizeof(int);
+            if (!ok) break;
+            list->resize(count);
+            ok = in.take(list->data(), count * sizeof(int));
+            for (int carIdx : *list) ok = ok && carIdx >= 0 && (uint64_t)carIdx < h.carCount;
+        }
+    }
+    std::vector<Car> newCars;
+    if (ok && h.carCount * sizeof(Car) == size - in.pos) {
+        const Car* first = (const Car*)(data + in.pos);
+        newCars.resize((size_t)h.carCount);
+        std::memcpy(newCars.data(), first, newCars.size() * sizeof(Car));
+        for (const Car& c : newCars) ok = ok && ValidCar(c, roads, parkings);
+    } else {
+        ok = false;
+    }
+    // Registre repris tel quel : il doit être celui de la flotte (sortie d'une liste en O(1))
+    std::vector<int> registrySlot;
+    ok = ok && IndexLotRegistry(newCars, newParkings, registrySlot);
+    // Contrôleur reconstruit sur la disposition (carrefours, plans), puis phases reprises
+    RoadNetwork network;
+    SignalController signals;
+    if (ok) network.build(newRoads, newParkings);
+    if (ok && headCount > 0) {
+        std::vector<Road> scratch = newRoads;   // build réécrit les feux : ceux du point de reprise priment
+        signals.build(scratch, network);
+        ok = signals.restore(signalTime, savedHeads, cycleStarts);
+    }
+    PricingEngine pricing;
+    pricing.policy = state.pricing.policy;
+    if (ok && pricedLots > 0) ok = pricing.restore(pricingTime, pricingNext, savedPrices, newParkings);
+    if (!ok) {
+        error = "point de reprise corrompu";
+        return false;
+    }
+
+    cars.swap(newCars);
+    roads.swap(newRoads);
+    parkings.swap(newParkings);
+
+    state.seed = h.seed;
+    state.tick = h.tick;
+    SimRng().state = h.simRngState;
+    state.clock.fixedDt = h.fixedDt;
+    state.clock.substeps = h.substeps;
+    state.clock.accumulator = h.accumulator;
+    state.clock.time = h.time;
+    state.clock.tick = h.clockTick;
+    state.clock.droppedTime = h.droppedTime;
+
+    // Registre restauré tel quel ; index des voies et réseau reconstruits depuis la flotte
+    state.registryCars = (int)cars.size();
+    state.registrySlot.swap(registrySlot);
+    state.network = network;
+    state.signals = signals;
+    state.pricing = pricing;
+    state.index.rebuild(cars, roads);
+
+    // Roue des voitures garées reprise ; tout le reste de la flotte est actif. Les voitures
+    // endormies ne sont plus écrites : le tampon arrière part de la flotte restaurée.
+    const int n = (int)cars.size();
+    state.next = cars;
+    state.parkedWheel.clear(n, wheelTime);
+    for (const auto& sleeper : sleepers) {
+        if (!state.parkedWheel.scheduled(sleeper.first)) state.parkedWheel.schedule(sleeper.first, sleeper.second);
+    }
+    state.active.resize(n);
+    for (int i = 0; i < n; i++) state.active[i] = i;
+    state.activeCars = n;
+    return true;
+}
+
+bool SaveCheckpoint(const std::string& path, const std::vector<Car>& cars, const std::vector<Road>& roads,
+                    const std::vector<ParkingLot>& parkings, const TrafficState& state, std::string& error) {
+    std::vector<uint8_t> buffer;
+    WriteCheckpoint(buffer, cars, roads, parkings, state);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)buffer.data(), (std::streamsize)buffer.size());
+    if (!out) {
+        error = path + " : ecriture impossible";
+        return false;
+    }
+    return true;
+}
+
+bool LoadCheckpoint(const std::string& path, std::vector<Car>& cars, std::vector<Road>& roads,
+                    std::vector<ParkingLot>& parkings, TrafficState& state, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = path + " : ouverture impossible";
+        return false;
+    }
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!ReadCheckpoint(buffer.data(), buffer.size(), cars, roads, parkings, state, error)) {
+        error = path + " : " + error;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,364 @@
+#include "../include/CityView.hpp"
+#include "../include/CarLogic.hpp"
+#include "../include/ParkingRender.hpp"
+#include "../include/Utils.hpp"
+#include "../include/Profiler.hpp"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+
+// Ligne d'arrêt et feu, en amont de la fin de route
+const float STOP_OFFSET = 200.0f;
+const float LIGHT_SHIFT_X = 60.0f;
+// Débord du dessin d'une route au-delà de son axe (bordure, poteau et boîtier du feu)
+const float ROAD_DRAW_MARGIN = 110.0f;
+// Panneau d'information d'un parking : décalé jusqu'à 280 px de la surface (voir DrawParking)
+const float LOT_LABEL_MARGIN = 280.0f;
+const float DASH_PERIOD = 40.0f;        // voir DrawDashedLine
+// Au-delà, deux poses successives d'une voiture ne sont pas interpolées (téléportation)
+const float INTERPOLATION_MAX_JUMP = 4 * CAR_LENGTH;
+
+// ---------------------------
+//  Grilles statiques
+// ---------------------------
+static Bounds SegmentBounds(Vec2 a, Vec2 b, float margin) {
+    Bounds box = { std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x), std::max(a.y, b.y) };
+    return box.grown(margin);
+}
+
+void BuildCityView(CityView& view, const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings) {
+    // Route d'accès de chaque parking (même déduction que la simulation)
+    RoadNetwork network;
+    network.build(roads, parkings);
+    view.lotRoads.resize(parkings.size());
+    for (size_t i = 0; i < parkings.size(); i++) view.lotRoads[i] = network.lotRoad((int)i);
+
+    std::vector<Bounds> boxes;
+    boxes.reserve(roads.size());
+    for (const Road& r : roads) boxes.push_back(SegmentBounds(r.start, r.end, r.width / 2 + ROAD_DRAW_MARGIN));
+    view.roadGrid.build(boxes);
+
+    // Parking : surface + allée jusqu'au point d'accès sur sa route (projection de l'entrée
+    // sur l'axe, quelle que soit l'orientation de la route) et point de sortie (voitures qui
+    // entrent ou sortent) + panneau
+    boxes.clear();
+    for (size_t i = 0; i < parkings.size(); i++) {
+        const ParkingLot& p = parkings[i];
+        Bounds box = { p.position.x, p.position.y, p.position.x + p.size.x, p.position.y + p.size.y };
+        auto include = [&box](Vec2 q) {
+            box = { std::min(box.minX, q.x), std::min(box.minY, q.y), std::max(box.maxX, q.x), std::max(box.maxY, q.y) };
+        };
+        include(p.exitPos);
+        if (view.lotRoads[i] >= 0) {
+            const RoadSegment& seg = network.segment(view.lotRoads[i]);
+            include(seg.pointAt(std::max(0.0f, std::min(seg.length, network.lotEntrance((int)i))), 0.0f));
+        }
+        boxes.push_back(box.grown(LOT_LABEL_MARGIN));
+    }
+    view.lotGrid.build(boxes);
+    view.staticValid = false;
+}
+
+// ---------------------------
+//  Caméra
+// ---------------------------
+void FitCityView(CityView& view, int screenW, int screenH) {
+    if (view.roadGrid.size() == 0 && view.lotGrid.size() == 0) return;
+    Bounds world = view.roadGrid.size() ? view.roadGrid.extent() : view.lotGrid.extent();
+    if (view.lotGrid.size()) {
+        const Bounds& lots = view.lotGrid.extent();
+        world = { std::min(world.minX, lots.minX), std::min(world.minY, lots.minY),
+                  std::max(world.maxX, lots.maxX), std::max(world.maxY, lots.maxY) };
+    }
+    float w = std::max(world.maxX - world.minX, 1.0f);
+    float h = std::max(world.maxY - world.minY, 1.0f);
+    view.camera.offset = { screenW / 2.0f, screenH / 2.0f };
+    view.camera.target = { (world.minX + world.maxX) / 2, (world.minY + world.maxY) / 2 };
+    view.camera.zoom = Clamp(0.95f * std::min(screenW / w, screenH / h), MIN_CAMERA_ZOOM, MAX_CAMERA_ZOOM);
+}
+
+void UpdateCityCamera(CityView& view, int screenW, int screenH) {
+    Camera2D& cam = view.camera;
+
+    // Zoom vers le curseur : le point monde sous la souris ne bouge pas
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        Vector2 mouse = GetMousePosition();
+        cam.target = GetScreenToWorld2D(mouse, cam);
+        cam.offset = mouse;
+        cam.zoom = Clamp(cam.zoom * powf(1.15f, wheel), MIN_CAMERA_ZOOM, MAX_CAMERA_ZOOM);
+    }
+
+    // Déplacement (le clic gauche reste aux curseurs de l'interface)
+    if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT) || IsMouseButtonDown(MOUSE_BUTTON_MIDDLE)) {
+        Vector2 delta = GetMouseDelta();
+        cam.target = Vector2Subtract(cam.target, Vector2Scale(delta, 1.0f / cam.zoom));
+    }
+
+    if (IsKeyPressed(KEY_HOME)) cam = CityView().camera;
+    if (IsKeyPressed(KEY_F)) FitCityView(view, screenW, screenH);
+}
+
+// ---------------------------
+//  Culling des voitures
+// ---------------------------
+static void CollectVisibleCars(CityView& view, const WorldSnapshot& world) {
+    const std::vector<Car>& cars = world.cars;
+    const std::vector<Road>& roads = world.roads;
+    std::vector<int>& out = view.visibleCars;
+    out.clear();
+    const Bounds zone = view.visibleArea.grown(CAR_LENGTH);
+    const int n = (int)cars.size();
+
+    // Index ou registre pas encore construits pour cette flotte (avant le premier tick) :
+    // test voiture par voiture
+    if (!world.registryValid || world.index.laneCount() == 0) {
+        for (int i = 0; i < n; i++) {
+            Vec2 pos;
+            float angle;
+            CarWorldPose(cars[i], roads, pos, angle);
+            if (zone.contains(pos)) out.push_back(i);
+        }
+        return;
+    }
+
+    // Sur les routes : portion visible de chaque voie, par l'index (DRIVING seulement ;
+    // les voitures TO_PARKING sont hors de la chaussée, on les prend par leur parking)
+    for (int r : view.visibleRoads) {
+        const Road& road = roads[r];
+        float t0, t1;
+        if (!ClipSegment(road.start, road.end, zone.grown(road.width / 2), t0, t1)) continue;
+        float length = road.getLength();
+        float lo = t0 * length - CAR_LENGTH, hi = t1 * length + CAR_LENGTH;
+        for (int lane = 0; lane < road.lanes; lane++) {
+            world.index.forEachInRange(r, lane, lo, hi, [&](int c, float) {
+                if (c < n && cars[c].state == DRIVING) out.push_back(c);
+                return true;
+            });
+        }
+    }
+
+    // Dans et autour des parkings visibles : voitures qui se garent, garées ou qui sortent
+    for (int l : view.visibleLots) {
+        const ParkingLot& p = world.parkings[l];
+        for (const std::vector<int>* list : {&p.entering, &p.parked, &p.leaving}) {
+            for (int c : *list)
+                if (c < n && cars[c].state != DRIVING) out.push_back(c);
+        }
+    }
+
+    // Ordre de la flotte, comme le dessin complet
+    std::sort(out.begin(), out.end());
+}
+
+// Pose affichée des voitures visibles : interpolée entre le pas précédent et le pas publié
+// selon le temps mural écoulé depuis la publication (l'affichage a au plus un pas de retard)
+static void InterpolateVisibleCars(CityView& view, const WorldSnapshot& world, double now) {
+    const size_t count = view.visibleCars.size();
+    view.shownPos.resize(count);
+    view.shownAngle.resize(count);
+
+    float alpha = 1.0f;
+    if (world.tickInterval > 0.0 && world.prevPos.size() == world.cars.size())
+        alpha = Clamp((float)((now - world.publishedAt) / world.tickInterval), 0.0f, 1.0f);
+
+    for (size_t k = 0; k < count; k++) {
+        int c = view.visibleCars[k];
+        Vec2 pos;
+        float angle;
+        CarWorldPose(world.cars[c], world.roads, pos, angle);
+        if (alpha < 1.0f) {
+            Vec2 prev = world.prevPos[c];
+            // Saut (changement de route en bout de boucle) : pas d'interpolation
+            if (Vec2Distance(prev, pos) < INTERPOLATION_MAX_JUMP) {
+                float turn = std::remainder(angle - world.prevAngle[c], 360.0f);   // plus court chemin
+                pos = { LerpF(prev.x, pos.x, alpha), LerpF(prev.y, pos.y, alpha) };
+                angle = angle - turn * (1.0f - alpha);
+            }
+        }
+        view.shownPos[k] = pos;
+        view.shownAngle[k] = angle;
+    }
+}
+
+// ---------------------------
+//  Routes
+// ---------------------------
+// Centre de la ligne d'arrêt et position du boîtier du feu
+static void StopAndLight(const Road& road, Vector2& stopLineCenter, Vector2& lightPos) {
+    Vector2 dir = ToVector2(road.getDir());
+    Vector2 normal = { -dir.y, dir.x };
+    stopLineCenter = Vector2Subtract(ToVector2(road.end), Vector2Scale(dir, STOP_OFFSET));
+    lightPos = Vector2Add(stopLineCenter, Vector2Scale(normal, road.width/2 + 30));
+    lightPos.x += LIGHT_SHIFT_X;
+}
+
+// Partie fixe : chaussée, marquage, ligne d'arrêt, poteau et boîtier du feu
+static void DrawRoadLayout(const Road& road, const Bounds& zone, bool detailed, float pixel) {
+    Vector2 start = ToVector2(road.start);
+    Vector2 dir = ToVector2(road.getDir());
+    Vector2 normal = { -dir.y, dir.x };
+
+    // Chaussée réduite à sa partie visible (les pointillés d'une longue route restent bornés)
+    float t0, t1;
+    if (ClipSegment(road.start, road.end, zone.grown(road.width), t0, t1)) {
+        float length = road.getLength();
+        Vector2 a = Vector2Add(start, Vector2Scale(dir, t0 * length));
+        Vector2 b = Vector2Add(start, Vector2Scale(dir, t1 * length));
+        if (!detailed) {
+            DrawLineEx(a, b, std::max(road.width, pixel), GetColor(0x333333FF));
+        } else {
+            DrawLineEx(a, b, road.width + 12, GRAY);
+            DrawLineEx(a, b, road.width, GetColor(0x333333FF));
+            // Premier tiret calé sur la période, comme si la ligne partait du début de la route
+            float dashStart = std::floor(t0 * length / DASH_PERIOD) * DASH_PERIOD;
+            DrawDashedLine(Vector2Add(start, Vector2Scale(dir, dashStart)), b, 2.0f, YELLOW);
+        }
+    }
+    if (!detailed) return;
+
+    Vector2 stopLineCenter, lightPos;
+    StopAndLight(road, stopLineCenter, lightPos);
+
+    // Ligne d'arrêt
+    Vector2 stopA = Vector2Add(stopLineCenter, Vector2Scale(normal,  road.width / 2));
+    Vector2 stopB = Vector2Add(stopLineCenter, Vector2Scale(normal, -road.width / 2));
+    DrawLineEx(stopA, stopB, 4.0f, WHITE);
+
+    // Feu tricolore (les lampes sont dans DrawRoadLights)
+    DrawLineEx(Vector2Add(stopLineCenter, Vector2Scale(normal, road.width/2)),
+               lightPos, 4.0f, DARKGRAY);
+    DrawRectangle((int)lightPos.x - 12, (int)lightPos.y - 35, 24, 70, BLACK);
+}
+
+// Partie variable : lampes du feu
+static void DrawRoadLights(const Road& road, bool detailed, float pixel) {
+    Vector2 stopLineCenter, lightPos;
+    StopAndLight(road, stopLineCenter, lightPos);
+
+    if (!detailed) {
+        // Feu réduit à une pastille de sa couleur (au moins 3 pixels)
+        Color lightColor = (road.light.state == LIGHT_RED) ? RED : (road.light.state == LIGHT_YELLOW) ? YELLOW : GREEN;
+        DrawCircleV(stopLineCenter, std::max(road.width / 2, 3 * pixel), lightColor);
+        return;
+    }
+
+    DrawCircle((int)lightPos.x, (int)lightPos.y - 22, 9,
+               (road.light.state == LIGHT_RED) ? RED : Fade(RED, 0.2f));
+    DrawCircle((int)lightPos.x, (int)lightPos.y, 9,
+               (road.light.state == LIGHT_YELLOW) ? YELLOW : Fade(YELLOW, 0.2f));
+    DrawCircle((int)lightPos.x, (int)lightPos.y + 22, 9,
+               (road.light.state == LIGHT_GREEN) ? GREEN : Fade(GREEN, 0.2f));
+}
+
+// ---------------------------
+//  Couche statique
+// ---------------------------
+static bool SameCamera(const Camera2D& a, const Camera2D& b) {
+    return a.offset.x == b.offset.x && a.offset.y == b.offset.y && a.target.x == b.target.x &&
+           a.target.y == b.target.y && a.rotation == b.rotation && a.zoom == b.zoom;
+}
+
+// Herbe, allées, surfaces des parkings et routes de la vue, rendues une fois dans la texture
+static void RenderStaticLayer(CityView& view, const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings,
+                              int screenW, int screenH, bool detailed, float pixel) {
+    if (view.staticLayer.id == 0 || view.staticLayer.texture.width != screenW ||
+        view.staticLayer.texture.height != screenH) {
+        if (view.staticLayer.id != 0) UnloadRenderTexture(view.staticLayer);
+        view.staticLayer = LoadRenderTexture(screenW, screenH);
+    }
+
+    BeginTextureMode(view.staticLayer);
+    ClearBackground(GetColor(0x228B22FF)); // herbe
+    BeginMode2D(view.camera);
+
+    // Allées (un parking sans route d'accès n'en a pas) puis parkings
+    for (int l : view.visibleLots) {
+        if (view.lotRoads[l] >= 0) DrawDriveway(parkings[l], roads[view.lotRoads[l]]);
+    }
+    for (int l : view.visibleLots) {
+        if (detailed) DrawParkingLayout(parkings[l]);
+        else DrawParkingSummaryLayout(parkings[l]);
+    }
+
+    // Routes + lignes d'arrêt + feux
+    for (int r : view.visibleRoads) DrawRoadLayout(roads[r], view.visibleArea, detailed, pixel);
+
+    EndMode2D();
+    EndTextureMode();
+
+    view.staticCamera = view.camera;
+    view.staticValid = true;
+    view.staticRedraws++;
+}
+
+void UnloadCityView(CityView& view) {
+    if (view.staticLayer.id != 0) UnloadRenderTexture(view.staticLayer);
+    view.staticLayer = RenderTexture2D();
+    view.staticValid = false;
+}
+
+// ---------------------------
+//  Trame
+// ---------------------------
+void DrawCity(CityView& view, const WorldSnapshot& world, double now, int screenW, int screenH) {
+    const std::vector<Road>& roads = world.roads;
+    const std::vector<ParkingLot>& parkings = world.parkings;
+    if (view.roadGrid.size() != roads.size() || view.lotGrid.size() != parkings.size()) {
+        BuildCityView(view, roads, parkings);
+    }
+
+    // Zone monde visible (caméra sans rotation : deux coins suffisent)
+    const Camera2D& cam = view.camera;
+    Vector2 topLeft = GetScreenToWorld2D({ 0, 0 }, cam);
+    Vector2 bottomRight = GetScreenToWorld2D({ (float)screenW, (float)screenH }, cam);
+    view.visibleArea = { topLeft.x, topLeft.y, bottomRight.x, bottomRight.y };
+    view.roadGrid.query(view.visibleArea, view.visibleRoads);
+    view.lotGrid.query(view.visibleArea, view.visibleLots);
+    {
+        ProfileScope scope(PROF_DRAW_CARS);
+        CollectVisibleCars(view, world);
+        InterpolateVisibleCars(view, world, now);
+    }
+
+    const bool detailed = cam.zoom >= LOD_DETAIL_ZOOM;
+    const float pixel = 1.0f / cam.zoom;   // taille d'un pixel écran en unités monde
+
+    // Partie fixe : redessinée seulement si la disposition, la caméra ou la fenêtre a changé
+    {
+        ProfileScope scope(PROF_DRAW_STATIC);
+        if (!view.staticValid || !SameCamera(view.staticCamera, cam) || view.staticLayer.texture.width != screenW ||
+            view.staticLayer.texture.height != screenH) {
+            RenderStaticLayer(view, roads, parkings, screenW, screenH, detailed, pixel);
+        }
+        // Les textures de rendu sont stockées à l'envers (origine OpenGL en bas)
+        const Texture2D& layer = view.staticLayer.texture;
+        DrawTextureRec(layer, { 0, 0, (float)layer.width, -(float)layer.height }, { 0, 0 }, WHITE);
+    }
+
+    // Partie variable : occupation des places, feux, voitures
+    BeginMode2D(cam);
+
+    {
+        ProfileScope scope(PROF_DRAW_PARKINGS);
+        for (int l : view.visibleLots) {
+            if (detailed) DrawParkingOccupancy(parkings[l]);
+            else DrawParkingSummaryOccupancy(parkings[l]);
+        }
+    }
+
+    {
+        ProfileScope scope(PROF_DRAW_LIGHTS);
+        for (int r : view.visibleRoads) DrawRoadLights(roads[r], detailed, pixel);
+    }
+
+    // Voitures
+    {
+        ProfileScope scope(PROF_DRAW_CARS);
+        CarDetail carDetail = detailed ? CAR_DETAIL_FULL
+                            : (cam.zoom >= LOD_POINT_ZOOM) ? CAR_DETAIL_BODY : CAR_DETAIL_POINT;
+        DrawCars(world.cars, view.visibleCars, view.shownPos, view.shownAngle, carDetail, std::max(CAR_LENGTH / 2, 2 * pixel));
+    }
+
+    EndMode2D();
+}
@@ -0,0 +1,257 @@
+#include "../include/LaneIndex.hpp"
+#include <algorithm>
+#include <limits>
+
+int LaneIndex::bucketId(int road, int lane) const {
+    if (road < 0 || road >= roadCount || lane < 0 || lane >= laneStride) return -1;
+    return road * laneStride + lane;
+}
+
+const std::vector<LaneIndex::Entry>* LaneIndex::bucket(const std::vector<std::vector<Entry>>& set, int road, int lane) const {
+    int id = bucketId(road, lane);
+    return (id < 0) ? nullptr : &set[id];
+}
+
+// Premier élément de clé strictement supérieure à key
+size_t LaneIndex::upperBound(const std::vector<Entry>& b, float key) {
+    return std::upper_bound(b.begin(), b.end(), key,
+                            [](float k, const Entry& e) { return k < e.key; }) - b.begin();
+}
+
+// Premier élément de clé supérieure ou égale à key
+size_t LaneIndex::lowerBound(const std::vector<Entry>& b, float key) {
+    return std::lower_bound(b.begin(), b.end(), key,
+                            [](const Entry& e, float k) { return e.key < k; }) - b.begin();
+}
+
+void LaneIndex::ensureCar(int carIdx) {
+    if (carIdx >= (int)laneSlot.size()) {
+        laneSlot.resize(carIdx + 1);
+        exitSlot.resize(carIdx + 1);
+    }
+}
+
+void LaneIndex::rebuild(const std::vector<Car>& cars, const std::vector<Road>& roads) {
+    roadCount = (int)roads.size();
+    laneStride = 2;
+    for (const auto& car : cars) laneStride = std::max(laneStride, car.currentLane + 1);
+
+    size_t bucketCount = (size_t)roadCount * laneStride;
+    lanes.resize(bucketCount);
+    exits.resize(bucketCount);
+    for (auto& b : lanes) b.clear();
+    for (auto& b : exits) b.clear();
+    laneSlot.assign(cars.size(), Slot());
+    exitSlot.assign(cars.size(), Slot());
+
+    // Parcours à rebours : à égalité de distance, la voiture d'indice le plus
+    // grand se retrouve derrière (le tri qui suit est stable).
+    for (int i = (int)cars.size() - 1; i >= 0; i--) {
+        const Car& car = cars[i];
+        int id = bucketId(car.roadIndex, car.currentLane);
+        if (id < 0) continue;
+        if (car.state == DRIVING || car.state == TO_PARKING) {
+            lanes[id].push_back({car.distance, i});
+        } else if (car.state == LEAVING_PARKING) {
+            exits[id].push_back({roads[car.roadIndex].projectDistance(car.targetPos), i});
+        }
+    }
+
+    auto byKey = [](const Entry& a, const Entry& b) { return a.key < b.key; };
+    for (int id = 0; id < (int)bucketCount; id++) {
+        for (auto* set : {&lanes, &exits}) {
+            auto& b = (*set)[id];
+            if (!std::is_sorted(b.begin(), b.end(), byKey))
+                std::stable_sort(b.begin(), b.end(), byKey);
+            auto& slots = (set == &lanes) ? laneSlot : exitSlot;
+            for (int pos = 0; pos < (int)b.size(); pos++) slots[b[pos].car] = {id, pos};
+        }
+    }
+}
+
+void LaneIndex::sync(const std::vector<Car>& cars, const std::vector<Road>& roads) {
+    int stride = 2;
+    for (const auto& car : cars) stride = std::max(stride, car.currentLane + 1);
+    if ((int)roads.size() != roadCount || stride != laneStride || cars.size() != laneSlot.size()) {
+        rebuild(cars, roads);
+        return;
+    }
+
+    // 1. Clés mises à jour en place; les voitures qui changent de seau sont retirées
+    laneMigrants.clear();
+    exitMigrants.clear();
+    for (int i = 0; i < (int)cars.size(); i++) syncKey(i, cars[i]);
+    finishSync(cars, roads);
+}
+
+void LaneIndex::sync(const std::vector<Car>& cars, const std::vector<Road>& roads, const std::vector<int>& changed) {
+    // Le nombre de voies ne fait que croître ici (une voie vide en trop ne gêne pas)
+    int stride = laneStride;
+    for (int i : changed) stride = std::max(stride, cars[i].currentLane + 1);
+    if ((int)roads.size() != roadCount || stride != laneStride || cars.size() != laneSlot.size()) {
+        rebuild(cars, roads);
+        return;
+    }
+
+    laneMigrants.clear();
+    exitMigrants.clear();
+    for (int i : changed) syncKey(i, cars[i]);
+    finishSync(cars, roads);
+}
+
+void LaneIndex::syncKey(int i, const Car& car) {
+    int id = bucketId(car.roadIndex, car.currentLane);
+    int wantLane = (id >= 0 && (car.state == DRIVING || car.state == TO_PARKING)) ? id : -1;
+    int wantExit = (id >= 0 && car.state == LEAVING_PARKING) ? id : -1;
+
+    if (laneSlot[i].bucket != wantLane) {
+        eraseEntry(lanes, laneSlot, i);
+        if (wantLane >= 0) laneMigrants.push_back(i);
+    } else if (wantLane >= 0) {
+        lanes[wantLane][laneSlot[i].pos].key = car.distance;
+    }
+
+    // La cible d'une voiture sortante ne bouge pas : sa clé reste valable
+    if (exitSlot[i].bucket != wantExit) {
+        eraseEntry(exits, exitSlot, i);
+        if (wantExit >= 0) exitMigrants.push_back(i);
+    }
+}
+
+void LaneIndex::finishSync(const std::vector<Car>& cars, const std::vector<Road>& roads) {
+    // 2. Tri par insertion de chaque voie (presque triée)
+    for (auto& b : lanes) insertionSort(b, laneSlot);
+
+    // 3. Réinsertion des voitures migrantes à leur place
+    for (int i : laneMigrants) {
+        const Car& car = cars[i];
+        insertEntry(lanes, laneSlot, bucketId(car.roadIndex, car.currentLane), i, car.distance);
+    }
+    for (int i : exitMigrants) {
+        const Car& car = cars[i];
+        insertEntry(exits, exitSlot, bucketId(car.roadIndex, car.currentLane), i,
+                    roads[car.roadIndex].projectDistance(car.targetPos));
+    }
+}
+
+// Tri par insertion stable, qui tient les positions à jour; O(n + inversions)
+void LaneIndex::insertionSort(std::vector<Entry>& b, std::vector<Slot>& slots) {
+    for (size_t i = 1; i < b.size(); i++) {
+        if (!(b[i].key < b[i - 1].key)) continue;
+        Entry e = b[i];
+        size_t j = i;
+        while (j > 0 && e.key < b[j - 1].key) {
+            b[j] = b[j - 1];
+            slots[b[j].car].pos = (int)j;
+            j--;
+        }
+        b[j] = e;
+        slots[e.car].pos = (int)j;
+    }
+}
+
+void LaneIndex::insertEntry(std::vector<std::vector<Entry>>& set, std::vector<Slot>& slots, int id, int carIdx, float key) {
+    auto& b = set[id];
+    size_t pos = upperBound(b, key);
+    b.insert(b.begin() + pos, {key, carIdx});
+    for (size_t i = pos; i < b.size(); i++) slots[b[i].car] = {id, (int)i};
+}
+
+void LaneIndex::eraseEntry(std::vector<std::vector<Entry>>& set, std::vector<Slot>& slots, int carIdx) {
+    if (carIdx < 0 || carIdx >= (int)slots.size()) return;
+    Slot s = slots[carIdx];
+    if (s.bucket < 0) return;
+    auto& b = set[s.bucket];
+    b.erase(b.begin() + s.pos);
+    for (size_t i = s.pos; i < b.size(); i++) slots[b[i].car].pos = (int)i;
+    slots[carIdx] = Slot();
+}
+
+void LaneIndex::moveCar(int carIdx, float newDistance) {
+    if (carIdx < 0 || carIdx >= (int)laneSlot.size()) return;
+    Slot& s = laneSlot[carIdx];
+    if (s.bucket < 0) return;
+    auto& b = lanes[s.bucket];
+    int pos = s.pos;
+    b[pos].key = newDistance;
+
+    // Les dépassements sont rares : on rétablit l'ordre par échanges successifs
+    while (pos + 1 < (int)b.size() && b[pos + 1].key < b[pos].key) {
+        std::swap(b[pos], b[pos + 1]);
+        laneSlot[b[pos].car].pos = pos;
+        pos++;
+    }
+    while (pos > 0 && b[pos - 1].key > b[pos].key) {
+        std::swap(b[pos], b[pos - 1]);
+        laneSlot[b[pos].car].pos = pos;
+        pos--;
+    }
+    laneSlot[carIdx].pos = pos;
+}
+
+void LaneIndex::insertCar(int carIdx, int road, int lane, float distance) {
+    int id = bucketId(road, lane);
+    if (id < 0) return;
+    ensureCar(carIdx);
+    eraseEntry(lanes, laneSlot, carIdx);
+    insertEntry(lanes, laneSlot, id, carIdx, distance);
+}
+
+void LaneIndex::removeCar(int carIdx) {
+    eraseEntry(lanes, laneSlot, carIdx);
+}
+
+void LaneIndex::insertLeaving(int carIdx, int road, int lane, float projectedDistance) {
+    int id = bucketId(road, lane);
+    if (id < 0) return;
+    ensureCar(carIdx);
+    eraseEntry(exits, exitSlot, carIdx);
+    insertEntry(exits, exitSlot, id, carIdx, projectedDistance);
+}
+
+void LaneIndex::removeLeaving(int carIdx) {
+    eraseEntry(exits, exitSlot, carIdx);
+}
+
+int LaneIndex::leader(int road, int lane, float distance) const {
+    const std::vector<Entry>* b = bucket(lanes, road, lane);
+    if (!b) return -1;
+    size_t i = upperBound(*b, distance);
+    return (i < b->size()) ? (*b)[i].car : -1;
+}
+
+int LaneIndex::leaderOf(int carIdx) const {
+    if (carIdx < 0 || carIdx >= (int)laneSlot.size()) return -1;
+    const Slot& s = laneSlot[carIdx];
+    if (s.bucket < 0) return -1;
+    const auto& b = lanes[s.bucket];
+    return (s.pos + 1 < (int)b.size()) ? b[s.pos + 1].car : -1;
+}
+
+int LaneIndex::follower(int road, int lane, float distance) const {
+    const std::vector<Entry>* b = bucket(lanes, road, lane);
+    if (!b) return -1;
+    size_t i = lowerBound(*b, distance);
+    return (i > 0) ? (*b)[i - 1].car : -1;
+}
+
+float LaneIndex::nearestLeavingAhead(int road, int lane, float distance) const {
+    const std::vector<Entry>* b = bucket(exits, road, lane);
+    if (!b) return std::numeric_limits<float>::max();
+    size_t i = upperBound(*b, distance);
+    return (i < b->size()) ? (*b)[i].key : std::numeric_limits<float>::max();
+}
+
+bool LaneIndex::anyInRange(int road, int lane, float lo, float hi, int excludeCar) const {
+    bool found = false;
+    forEachInRange(road, lane, lo, hi, [&](int carIdx, float) {
+        if (carIdx == excludeCar) return true;
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool LaneIndex::anyWithin(int road, int lane, float distance, float range, int excludeCar) const {
+    return anyInRange(road, lane, distance - range, distance + range, excludeCar);
+}
@@ -0,0 +1,176 @@
+#include "../include/LotIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+void LotIndex::build(const RoadNetwork& network, const std::vector<ParkingLot>& parkings) {
+    const int lotCount = (int)parkings.size();
+    position.resize(lotCount);
+    entrance.resize(lotCount);
+    price.resize(lotCount);
+    free.resize(lotCount);
+    lotNode.assign(lotCount, -1);
+    for (int p = 0; p < lotCount; p++) {
+        position[p] = parkings[p].position;
+        entrance[p] = network.lotEntrance(p);
+        price[p] = parkings[p].price;
+        free[p] = !parkings[p].isFull();
+    }
+
+    const int roadCount = network.segmentCount();
+    laneBase.assign(roadCount + 1, 0);
+    for (int s = 0; s < roadCount; s++) laneBase[s + 1] = laneBase[s] + network.segment(s).lanes;
+    laneRoot.assign(laneBase[roadCount], -1);
+
+    nodes.clear();
+    nodes.reserve(lotCount);
+    std::vector<int> lots;
+    for (int s = 0; s < roadCount; s++) {
+        for (int lane = 0; lane < network.segment(s).lanes; lane++) {
+            lots = network.lotsOnLane(s, lane);
+            laneRoot[laneBase[s] + lane] = buildNode(lots, 0, (int)lots.size(), 0, -1);
+        }
+    }
+    built = true;
+}
+
+// Coupe à la médiane, en x aux profondeurs paires, en y aux impaires (indice du parking
+// pour départager : même arbre d'une construction à l'autre)
+int LotIndex::buildNode(std::vector<int>& lots, int begin, int end, int depth, int parent) {
+    if (begin >= end) return -1;
+    const int mid = (begin + end) / 2;
+    const bool alongX = depth % 2 == 0;
+    std::nth_element(lots.begin() + begin, lots.begin() + mid, lots.begin() + end, [&](int a, int b) {
+        float ka = alongX ? position[a].x : position[a].y;
+        float kb = alongX ? position[b].x : position[b].y;
+        return ka < kb || (ka == kb && a < b);
+    });
+
+    const int id = (int)nodes.size();
+    nodes.push_back(Node());
+    nodes[id].lot = lots[mid];
+    nodes[id].parent = parent;
+    lotNode[lots[mid]] = id;
+    int left = buildNode(lots, begin, mid, depth + 1, id);
+    int right = buildNode(lots, mid + 1, end, depth + 1, id);
+    nodes[id].left = left;
+    nodes[id].right = right;
+    pull(id);
+    return id;
+}
+
+// Boîte, prix minimal et entrée la plus loin du noeud depuis son parking et ses enfants
+void LotIndex::pull(int node) {
+    Node& n = nodes[node];
+    Vec2 p = position[n.lot];
+    n.box = { p.x, p.y, p.x, p.y };
+    n.minPrice = ownPrice(n.lot);
+    n.maxEntrance = entrance[n.lot];
+    for (int child : {n.left, n.right}) {
+        if (child < 0) continue;
+        const Node& c = nodes[child];
+        n.box = { std::min(n.box.minX, c.box.minX), std::min(n.box.minY, c.box.minY),
+                  std::max(n.box.maxX, c.box.maxX), std::max(n.box.maxY, c.box.maxY) };
+        n.minPrice = std::min(n.minPrice, c.minPrice);
+        n.maxEntrance = std::max(n.maxEntrance, c.maxEntrance);
+    }
+}
+
+void LotIndex::update(int lot, const ParkingLot& parking) {
+    unsigned char isFree = !parking.isFull();
+    if (free[lot] == isFree && price[lot] == parking.price) return;
+    free[lot] = isFree;
+    price[lot] = parking.price;
+
+    // Remontée tant que le prix minimal du sous-arbre change
+    for (int n = lotNode[lot]; n != -1; n = nodes[n].parent) {
+        float before = nodes[n].minPrice;
+        pull(n);
+        if (nodes[n].minPrice == before) break;
+    }
+}
+
+void LotIndex::refresh(const std::vector<ParkingLot>& parkings) {
+    for (int p = 0; p < (int)parkings.size(); p++) update(p, parkings[p]);
+}
+
+int LotIndex::root(int road, int lane) const {
+    if (road < 0 || road + 1 >= (int)laneBase.size() || lane < 0 || lane >= laneBase[road + 1] - laneBase[road])
+        return -1;
+    return laneRoot[laneBase[road] + lane];
+}
+
+// Distance à la boîte d'un noeud : borne inférieure de la distance à ses parkings
+static double BoxDistance(const Bounds& box, Vec2 p) {
+    double dx = std::max({ (double)box.minX - p.x, 0.0, (double)p.x - box.maxX });
+    double dy = std::max({ (double)box.minY - p.y, 0.0, (double)p.y - box.maxY });
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void LotIndex::search(int node, Vec2 from, size_t k, float maxPrice, std::pair<float, int>* best, size_t& count) const {
+    if (node < 0) return;
+    const Node& n = nodes[node];
+    if (n.minPrice > maxPrice || std::isinf(n.minPrice)) return;    // rien de disponible au prix
+    // Marge relative : les distances retenues sont calculées en float (Vec2Distance),
+    // une égalité ne doit pas être écartée par un arrondi
+    if (count == k && BoxDistance(n.box, from) * (1.0 - 1e-5) > best[count - 1].first) return;
+
+    if (free[n.lot] && price[n.lot] <= maxPrice) {
+        std::pair<float, int> candidate(Vec2Distance(from, position[n.lot]), n.lot);
+        if (count < k || candidate < best[count - 1]) {
+            size_t j = (count < k) ? count++ : count - 1;
+            while (j > 0 && candidate < best[j - 1]) {
+                best[j] = best[j - 1];
+                j--;
+            }
+            best[j] = candidate;
+        }
+    }
+
+    // L'enfant le plus proche d'abord : l'autre a plus de chances d'être écarté
+    int first = n.left, second = n.right;
+    if (first >= 0 && second >= 0 && BoxDistance(nodes[second].box, from) < BoxDistance(nodes[first].box, from))
+        std::swap(first, second);
+    search(first, from, k, maxPrice, best, count);
+    search(second, from, k, maxPrice, best, count);
+}
+
+int LotIndex::nearest(int road, int lane, Vec2 from, float maxPrice) const {
+    std::pair<float, int> best;
+    size_t count = 0;
+    search(root(road, lane), from, 1, maxPrice, &best, count);
+    return (count > 0) ? best.second : -1;
+}
+
+void LotIndex::nearest(int road, int lane, Vec2 from, int k, float maxPrice, std::vector<int>& out) const {
+    out.clear();
+    if (k <= 0) return;
+    std::vector<std::pair<float, int>> best(k);
+    size_t count = 0;
+    search(root(road, lane), from, (size_t)k, maxPrice, best.data(), count);
+    for (size_t i = 0; i < count; i++) out.push_back(best[i].second);
+}
+
+// Borne inférieure du coût d'un sous-arbre : distance à sa boîte + poids x son prix minimal
+void LotIndex::searchCheapest(int node, Vec2 from, float priceWeight, float after, std::pair<float, int>& best) const {
+    if (node < 0) return;
+    const Node& n = nodes[node];
+    if (std::isinf(n.minPrice) || n.maxEntrance <= after) return;     // rien de disponible devant
+    auto bound = [&](const Node& b) { return BoxDistance(b.box, from) + (double)priceWeight * b.minPrice; };
+    if (best.second != -1 && bound(n) * (1.0 - 1e-5) > best.first) return;
+
+    if (free[n.lot] && entrance[n.lot] > after) {
+        std::pair<float, int> candidate(Vec2Distance(from, position[n.lot]) + priceWeight * price[n.lot], n.lot);
+        if (best.second == -1 || candidate < best) best = candidate;
+    }
+
+    int first = n.left, second = n.right;
+    if (first >= 0 && second >= 0 && bound(nodes[second]) < bound(nodes[first])) std::swap(first, second);
+    searchCheapest(first, from, priceWeight, after, best);
+    searchCheapest(second, from, priceWeight, after, best);
+}
+
+int LotIndex::cheapest(int road, int lane, Vec2 from, float priceWeight, float after) const {
+    std::pair<float, int> best(0.0f, -1);
+    searchCheapest(root(road, lane), from, priceWeight, after, best);
+    return best.second;
+}
@@ -1,88 +1,99 @@
-#include "../include/ParkingLogic.hpp"
-#include "raylib.h"
-#include <cstring>
-
-// Vide car la gestion de l'occupation est faite par la simulation voiture
-void UpdateParking(ParkingLot& p) {}
-
-// Calcul la position centrale d'une place dans la grille du parking
-Vector2 GetSpotPosition(const ParkingLot& p, int spotIndex) {
-    float spotWidth = 24.0f;
-    float spotHeight = 40.0f;
-    float padding = 8.0f;
-    int cols = (p.size.x - padding) / (spotWidth + padding);
-    if (cols <= 0) cols = 1;
-
-    int row = spotIndex / cols;
-    int col = spotIndex % cols;
-
-    float x = p.position.x + padding + col * (spotWidth + padding);
-    float y = p.position.y + 10 + row * (spotHeight + padding);
-
-    return { x + spotWidth / 2, y + spotHeight / 2 };
-}
-
-
-
-// Affichage graphique complet du parking avec places individuelles
-void DrawParking(const ParkingLot& p) {
-    // Surface du parking (bitume)
-    DrawRectangleV(p.position, p.size, GetColor(0x2A2A2AFF));
-    DrawRectangleLines(p.position.x, p.position.y, p.size.x, p.size.y, WHITE);
-
-    // Panneau d'information avec nom et prix
-    float xOffset = 0.0f;
-    float yOffset = 0.0f;
-
-    if (std::strcmp(p.name, "Central") == 0) {
-        xOffset = -100.0f; 
-    } else if (std::strcmp(p.name, "City") == 0) {
-        xOffset = -100.0f; 
-    } else if (std::strcmp(p.name, "Eco") == 0) {
-        xOffset = 180.0f; 
-    } else if (std::strcmp(p.name, "VIP") == 0) {
-        xOffset = 150.0f; 
-        yOffset = 80.0f;   
-    }
-
-    DrawRectangle(p.position.x + xOffset, p.position.y - 25 + yOffset, 100, 25, p.color);
-    DrawText(p.name, p.position.x + 5 + xOffset, p.position.y - 22 + yOffset, 10, WHITE);
-    DrawText(TextFormat("%.0fdh/h", p.price), p.position.x + 5 + xOffset, p.position.y - 10 + yOffset, 10, WHITE);
-
-    float spotWidth = 24.0f;
-    float spotHeight = 40.0f;
-    float padding = 8.0f;
-    int cols = (p.size.x - padding) / (spotWidth + padding);
-    if (cols <= 0) cols = 1;
-
-    // Dessin des places en grille
-    for (int i = 0; i < p.capacity; i++) {
-        int row = i / cols;
-        int col = i % cols;
-
-        float x = p.position.x + padding + col * (spotWidth + padding);
-        float y = p.position.y + 10 + row * (spotHeight + padding);
-
-        if (y + spotHeight > p.position.y + p.size.y) break;
-
-        // Lignes blanches pour démarquer les places
-        DrawRectangleLines(x, y, spotWidth, spotHeight, LIGHTGRAY);
-    }
-
-    for (int i = 0; i < p.capacity; ++i) {
-    int row = i / cols;
-    int col = i % cols;
-    float x = p.position.x + padding + col * (spotWidth + padding);
-    float y = p.position.y + 10 + row * (spotHeight + padding);
-    if (y + spotHeight > p.position.y + p.size.y) break;
-
-    if (p.spotsOccupied[i]) {
-        // Place occupée : couleur voiture garée
-        DrawRectangle(x + 2, y + 2, spotWidth - 4, spotHeight - 4, RED);
-    } else {
-        // Place libre : fond sombre (bitume)
-        DrawRectangle(x + 2, y + 2, spotWidth - 4, spotHeight - 4, DARKGRAY);
-    }
-    DrawRectangleLines(x, y, spotWidth, spotHeight, WHITE);
-    }
-}
\ No newline at end of file
+#include "../include/ParkingLogic.hpp"
+#include "../include/Trace.hpp"
+
+// Vide car la gestion de l'occupation est faite par la simulation voiture
+void UpdateParking(ParkingLot& p) {}
+
+bool ValidCar(const Car& c, const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings) {
+    const int state = (int)c.state;
+    if (state < DRIVING || state > LEAVING_PARKING) return false;
+    if (c.roadIndex < 0 || c.roadIndex >= (int)roads.size()) return false;
+    const int lanes = roads[c.roadIndex].lanes;
+    if (c.currentLane < 0 || c.currentLane >= lanes || c.targetLane < 0 || c.targetLane >= lanes) return false;
+    if (c.parkingIdx < -1 || c.parkingIdx >= (int)parkings.size() || c.spotIdx < -1) return false;
+    if (c.parkingIdx >= 0 && c.spotIdx >= parkings[c.parkingIdx].capacity) return false;
+    if (state != DRIVING && (c.parkingIdx < 0 || c.spotIdx < 0)) return false;
+    return true;
+}
+
+// Calcul la position centrale d'une place dans la grille du parking
+Vec2 GetSpotPosition(const ParkingLot& p, int spotIndex) {
+    float spotWidth = 24.0f;
+    float spotHeight = 40.0f;
+    float padding = 8.0f;
+    int cols = (p.size.x - padding) / (spotWidth + padding);
+    if (cols <= 0) cols = 1;
+
+    int row = spotIndex / cols;
+    int col = spotIndex % cols;
+
+    float x = p.position.x + padding + col * (spotWidth + padding);
+    float y = p.position.y + 10 + row * (spotHeight + padding);
+
+    return { x + spotWidth / 2, y + spotHeight / 2 };
+}
+
+// Liste du registre concernée par la voiture (nullptr si elle n'est liée à aucun parking)
+static std::vector<int>* RegistryList(const Car& car, std::vector<ParkingLot>& parkings) {
+    if (car.parkingIdx < 0 || car.parkingIdx >= (int)parkings.size()) return nullptr;
+    ParkingLot& p = parkings[car.parkingIdx];
+    if (car.state == PARKED) return &p.parked;
+    if (car.state == LEAVING_PARKING) return &p.leaving;
+    return &p.entering; // DRIVING (en approche) ou TO_PARKING
+}
+
+void RebuildLotRegistry(const std::vector<Car>& cars, std::vector<ParkingLot>& parkings, std::vector<int>& slots) {
+    TRACE_SCOPE("registre des parkings");
+    for (auto& p : parkings) {
+        p.entering.clear();
+        p.parked.clear();
+        p.leaving.clear();
+    }
+    slots.assign(cars.size(), -1);
+    for (int i = 0; i < (int)cars.size(); i++) {
+        std::vector<int>* list = RegistryList(cars[i], parkings);
+        if (!list) continue;
+        slots[i] = (int)list->size();
+        list->push_back(i);
+    }
+}
+
+bool IndexLotRegistry(const std::vector<Car>& cars, std::vector<ParkingLot>& parkings, std::vector<int>& slots) {
+    const int n = (int)cars.size();
+    slots.assign(n, -1);
+    for (ParkingLot& p : parkings) {
+        for (std::vector<int>* list : {&p.entering, &p.parked, &p.leaving}) {
+            for (int k = 0; k < (int)list->size(); k++) {
+                int carIdx = (*list)[k];
+                if (carIdx < 0 || carIdx >= n || slots[carIdx] != -1 || RegistryList(cars[carIdx], parkings) != list)
+                    return false;
+                slots[carIdx] = k;
+            }
+        }
+    }
+    // Chaque voiture liée à un parking y est listée
+    for (int i = 0; i < n; i++)
+        if (slots[i] == -1 && RegistryList(cars[i], parkings)) return false;
+    return true;
+}
+
+void UpdateLotRegistry(int carIdx, const Car& before, const Car& after, std::vector<ParkingLot>& parkings,
+                       std::vector<int>& slots) {
+    std::vector<int>* from = RegistryList(before, parkings);
+    std::vector<int>* to = RegistryList(after, parkings);
+    if (from == to) return;
+
+    if (from) {
+        // La dernière voiture de la liste prend la place de celle qui sort
+        int slot = slots[carIdx];
+        int last = from->back();
+        (*from)[slot] = last;
+        slots[last] = slot;
+        from->pop_back();
+        slots[carIdx] = -1;
+    }
+    if (to) {
+        slots[carIdx] = (int)to->size();
+        to->push_back(carIdx);
+    }
+}
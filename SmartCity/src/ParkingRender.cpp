@@ -0,0 +1,95 @@
+#include "../include/ParkingRender.hpp"
+#include "../include/Utils.hpp"
+#include "raylib.h"
+#include <cstring>
+
+// Grille des places, rangée par rangée, tant qu'elles tiennent dans la surface
+const float SPOT_WIDTH = 24.0f;
+const float SPOT_HEIGHT = 40.0f;
+const float SPOT_PADDING = 8.0f;
+
+static int SpotColumns(const ParkingLot& p) {
+    int cols = (p.size.x - SPOT_PADDING) / (SPOT_WIDTH + SPOT_PADDING);
+    return (cols <= 0) ? 1 : cols;
+}
+
+// Coin haut-gauche de la place i ; false si elle dépasse du parking (et toutes les suivantes)
+static bool SpotCorner(const ParkingLot& p, int i, int cols, float& x, float& y) {
+    int row = i / cols;
+    int col = i % cols;
+    x = p.position.x + SPOT_PADDING + col * (SPOT_WIDTH + SPOT_PADDING);
+    y = p.position.y + 10 + row * (SPOT_HEIGHT + SPOT_PADDING);
+    return y + SPOT_HEIGHT <= p.position.y + p.size.y;
+}
+
+// Affichage graphique complet du parking avec places individuelles
+void DrawParking(const ParkingLot& p) {
+    DrawParkingLayout(p);
+    DrawParkingOccupancy(p);
+}
+
+// Partie fixe : surface, contour et places (toutes dessinées libres)
+void DrawParkingLayout(const ParkingLot& p) {
+    // Surface du parking (bitume)
+    DrawRectangleV(ToVector2(p.position), ToVector2(p.size), GetColor(0x2A2A2AFF));
+    DrawRectangleLines(p.position.x, p.position.y, p.size.x, p.size.y, WHITE);
+
+    // Dessin des places en grille : fond sombre (bitume) et lignes blanches
+    const int cols = SpotColumns(p);
+    float x, y;
+    for (int i = 0; i < p.capacity && SpotCorner(p, i, cols, x, y); i++) {
+        DrawRectangle(x + 2, y + 2, SPOT_WIDTH - 4, SPOT_HEIGHT - 4, DARKGRAY);
+        DrawRectangleLines(x, y, SPOT_WIDTH, SPOT_HEIGHT, WHITE);
+    }
+}
+
+// Partie variable : panneau (nom, prix) et places occupées, par-dessus DrawParkingLayout
+void DrawParkingOccupancy(const ParkingLot& p) {
+    // Panneau d'information avec nom et prix
+    float xOffset = 0.0f;
+    float yOffset = 0.0f;
+
+    if (std::strcmp(p.name, "Central") == 0) {
+        xOffset = -100.0f; 
+    } else if (std::strcmp(p.name, "City") == 0) {
+        xOffset = -100.0f; 
+    } else if (std::strcmp(p.name, "Eco") == 0) {
+        xOffset = 180.0f; 
+    } else if (std::strcmp(p.name, "VIP") == 0) {
+        xOffset = 150.0f; 
+        yOffset = 80.0f;   
+    }
+
+    DrawRectangle(p.position.x + xOffset, p.position.y - 25 + yOffset, 100, 25, ToColor(p.color));
+    DrawText(p.name, p.position.x + 5 + xOffset, p.position.y - 22 + yOffset, 10, WHITE);
+    DrawText(TextFormat("%.0fdh/h", p.price), p.position.x + 5 + xOffset, p.position.y - 10 + yOffset, 10, WHITE);
+
+    // Place occupée : couleur voiture garée, à l'intérieur des lignes de la place
+    if (p.occupiedCount() == 0) return;
+    const int cols = SpotColumns(p);
+    float x, y;
+    for (int i = 0; i < p.capacity && SpotCorner(p, i, cols, x, y); i++) {
+        if (p.isOccupied(i)) DrawRectangle(x + 2, y + 2, SPOT_WIDTH - 4, SPOT_HEIGHT - 4, RED);
+    }
+}
+
+// Vue dézoomée : un rectangle teinté selon le taux d'occupation (mêmes seuils que le tableau de bord)
+void DrawParkingSummary(const ParkingLot& p) {
+    DrawParkingSummaryLayout(p);
+    DrawParkingSummaryOccupancy(p);
+}
+
+void DrawParkingSummaryLayout(const ParkingLot& p) {
+    Rectangle area = { p.position.x, p.position.y, p.size.x, p.size.y };
+    DrawRectangleRec(area, GetColor(0x2A2A2AFF));
+    DrawRectangleLinesEx(area, 2.0f, ToColor(p.color));
+}
+
+void DrawParkingSummaryOccupancy(const ParkingLot& p) {
+    float ratio = (p.capacity > 0) ? (float)p.occupiedCount() / (float)p.capacity : 0.0f;
+    Color c = (ratio < 0.7f) ? GREEN : (ratio < 0.9f) ? ORANGE : RED;
+
+    // Jauge à l'intérieur du contour
+    Rectangle fill = { p.position.x + 2, p.position.y + 2, (p.size.x - 4) * ratio, p.size.y - 4 };
+    DrawRectangleRec(fill, Fade(c, 0.85f));
+}
@@ -0,0 +1,177 @@
+#include "../include/Pricing.hpp"
+#include "../include/Trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SMARTCITY_SSE2 1
+#endif
+
+const double PRICING_PI = 3.14159265358979323846;
+// Parkings traités par bloc : lecture, noyau et écriture d'un bloc tant qu'il est en cache
+const size_t PRICING_BLOCK = 512;
+
+static float Occupancy(const ParkingLot& p) {
+    return (p.capacity > 0) ? (float)p.occupiedCount() / (float)p.capacity : 0.0f;
+}
+
+void PricingEngine::build(std::vector<ParkingLot>& parkings) {
+    const size_t n = parkings.size();
+    lots.base.resize(n);
+    lots.price.resize(n);
+    lots.occupancy.resize(n);
+    lots.trend.assign(n, 0.0f);
+    for (size_t i = 0; i < n; i++) {
+        const float base = std::max(parkings[i].basePrice, policy.minBasePrice);
+        lots.base[i] = base;
+        lots.price[i] = std::min(std::max(parkings[i].price, base * policy.minFactor), base * policy.maxFactor);
+        parkings[i].price = lots.price[i];
+        lots.occupancy[i] = Occupancy(parkings[i]);
+    }
+    time = 0.0;
+    next = policy.interval;
+    built = true;
+}
+
+bool PricingEngine::update(double dt, std::vector<ParkingLot>& parkings) {
+    time += dt;
+    if (time < next) return false;
+    // Une seule révision même si plusieurs intervalles ont été franchis
+    while (next <= time) next += policy.interval;
+    reprice(parkings);
+    return true;
+}
+
+// Pointe de demande au milieu de la journée : 1 à minuit, 1 + peakAmplitude à midi
+float PricingEngine::timeOfDayFactor(double t) const {
+    double day = std::fmod(t + policy.dayStart, policy.dayLength) / policy.dayLength;
+    return (float)(1.0 + policy.peakAmplitude * 0.5 * (1.0 - std::cos(2.0 * PRICING_PI * day)));
+}
+
+void PricingEngine::reprice(std::vector<ParkingLot>& parkings) {
+    TRACE_SCOPE("revision des tarifs");
+    const size_t n = lots.base.size();
+    const float factor = timeOfDayFactor(time);
+    measured.resize(n);
+    for (size_t begin = 0; begin < n; begin += PRICING_BLOCK) {
+        const size_t end = std::min(begin + PRICING_BLOCK, n);
+        for (size_t i = begin; i < end; i++) measured[i] = Occupancy(parkings[i]);
+        RepriceLots(lots, measured.data(), policy, factor, begin, end);
+        for (size_t i = begin; i < end; i++) parkings[i].price = lots.price[i];
+    }
+}
+
+bool PricingEngine::restore(double savedTime, double savedNext, const LotPrices& saved,
+                            std::vector<ParkingLot>& parkings) {
+    const size_t n = parkings.size();
+    if (saved.base.size() != n || saved.price.size() != n || saved.occupancy.size() != n || saved.trend.size() != n)
+        return false;
+    lots = saved;
+    time = savedTime;
+    next = savedNext;
+    built = true;
+    for (size_t i = 0; i < n; i++) parkings[i].price = lots.price[i];
+    return true;
+}
+
+void RepriceLots(LotPrices& lots, const float* measured, const PricingPolicy& policy, float factor,
+                 size_t begin, size_t end) {
+    const size_t count = std::min(end, lots.base.size());
+    float* base = lots.base.data();
+    float* price = lots.price.data();
+    float* occupancy = lots.occupancy.data();
+    float* trend = lots.trend.data();
+    size_t i = begin;
+
+#if defined(__AVX2__)
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 target = _mm256_set1_ps(policy.targetOccupancy);
+    const __m256 occGain = _mm256_set1_ps(policy.occupancyGain);
+    const __m256 trendGain = _mm256_set1_ps(policy.trendGain);
+    const __m256 smoothing = _mm256_set1_ps(policy.trendSmoothing);
+    const __m256 minFactor = _mm256_set1_ps(policy.minFactor);
+    const __m256 maxFactor = _mm256_set1_ps(policy.maxFactor);
+    const __m256 maxStep = _mm256_set1_ps(policy.maxStep);
+    const __m256 hour = _mm256_set1_ps(factor);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 epsilon = _mm256_set1_ps(PRICING_TREND_EPSILON);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    for (; i + 8 <= count; i += 8) {
+        __m256 m = _mm256_loadu_ps(measured + i);
+        __m256 b = _mm256_loadu_ps(base + i);
+        __m256 p = _mm256_loadu_ps(price + i);
+        __m256 t = _mm256_loadu_ps(trend + i);
+        __m256 delta = _mm256_sub_ps(m, _mm256_loadu_ps(occupancy + i));
+        t = _mm256_add_ps(t, _mm256_mul_ps(smoothing, _mm256_sub_ps(delta, t)));
+        t = _mm256_and_ps(t, _mm256_cmp_ps(_mm256_and_ps(t, absMask), epsilon, _CMP_GE_OQ));
+
+        __m256 rel = _mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(occGain, _mm256_sub_ps(m, target))),
+                                   _mm256_mul_ps(trendGain, t));
+        __m256 goal = _mm256_mul_ps(_mm256_mul_ps(b, hour), rel);
+        goal = _mm256_min_ps(_mm256_max_ps(goal, _mm256_mul_ps(b, minFactor)), _mm256_mul_ps(b, maxFactor));
+        __m256 limit = _mm256_mul_ps(p, maxStep);
+        __m256 step = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(goal, p), _mm256_sub_ps(zero, limit)), limit);
+
+        _mm256_storeu_ps(trend + i, t);
+        _mm256_storeu_ps(occupancy + i, m);
+        _mm256_storeu_ps(price + i, _mm256_add_ps(p, step));
+    }
+#elif defined(SMARTCITY_SSE2)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 target = _mm_set1_ps(policy.targetOccupancy);
+    const __m128 occGain = _mm_set1_ps(policy.occupancyGain);
+    const __m128 trendGain = _mm_set1_ps(policy.trendGain);
+    const __m128 smoothing = _mm_set1_ps(policy.trendSmoothing);
+    const __m128 minFactor = _mm_set1_ps(policy.minFactor);
+    const __m128 maxFactor = _mm_set1_ps(policy.maxFactor);
+    const __m128 maxStep = _mm_set1_ps(policy.maxStep);
+    const __m128 hour = _mm_set1_ps(factor);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon = _mm_set1_ps(PRICING_TREND_EPSILON);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (; i + 4 <= count; i += 4) {
+        __m128 m = _mm_loadu_ps(measured + i);
+        __m128 b = _mm_loadu_ps(base + i);
+        __m128 p = _mm_loadu_ps(price + i);
+        __m128 t = _mm_loadu_ps(trend + i);
+        __m128 delta = _mm_sub_ps(m, _mm_loadu_ps(occupancy + i));
+        t = _mm_add_ps(t, _mm_mul_ps(smoothing, _mm_sub_ps(delta, t)));
+        t = _mm_and_ps(t, _mm_cmpge_ps(_mm_and_ps(t, absMask), epsilon));
+
+        __m128 rel = _mm_add_ps(_mm_add_ps(one, _mm_mul_ps(occGain, _mm_sub_ps(m, target))),
+                                _mm_mul_ps(trendGain, t));
+        __m128 goal = _mm_mul_ps(_mm_mul_ps(b, hour), rel);
+        goal = _mm_min_ps(_mm_max_ps(goal, _mm_mul_ps(b, minFactor)), _mm_mul_ps(b, maxFactor));
+        __m128 limit = _mm_mul_ps(p, maxStep);
+        __m128 step = _mm_min_ps(_mm_max_ps(_mm_sub_ps(goal, p), _mm_sub_ps(zero, limit)), limit);
+
+        _mm_storeu_ps(trend + i, t);
+        _mm_storeu_ps(occupancy + i, m);
+        _mm_storeu_ps(price + i, _mm_add_ps(p, step));
+    }
+#endif
+
+    // Reste (ou plateforme sans SIMD) : même formule, mêmes opérations, en scalaire
+    for (; i < count; i++) {
+        float m = measured[i];
+        float b = base[i];
+        float p = price[i];
+        float t = trend[i];
+        float delta = m - occupancy[i];
+        t = t + policy.trendSmoothing * (delta - t);
+        if (!(std::abs(t) >= PRICING_TREND_EPSILON)) t = 0.0f;
+
+        float rel = (1.0f + policy.occupancyGain * (m - policy.targetOccupancy)) + policy.trendGain * t;
+        float goal = (b * factor) * rel;
+        goal = std::min(std::max(goal, b * policy.minFactor), b * policy.maxFactor);
+        float limit = p * policy.maxStep;
+        float step = std::min(std::max(goal - p, 0.0f - limit), limit);
+
+        trend[i] = t;
+        occupancy[i] = m;
+        price[i] = p + step;
+    }
+}
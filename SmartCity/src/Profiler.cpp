@@ -0,0 +1,104 @@
+#include "../include/Profiler.hpp"
+#include <algorithm>
+#include <fstream>
+
+// Enregistrement en cours, par thread
+static thread_local double currentRecord[PROF_ZONE_COUNT] = {};
+
+Profiler& GlobalProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+const char* Profiler::zoneName(ProfileZone zone) {
+    static const char* const names[PROF_ZONE_COUNT] = {
+        "tick", "feux", "tri des voies", "perception", "decision", "application", "instantane",
+        "trame", "couche statique", "parkings", "feux (dessin)", "voitures", "interface"
+    };
+    return names[zone];
+}
+
+ProfileTrack Profiler::zoneTrack(ProfileZone zone) {
+    return (zone < PROF_FRAME) ? PROF_TRACK_SIM : PROF_TRACK_RENDER;
+}
+
+void Profiler::add(ProfileZone zone, double ms) {
+    if (isEnabled()) currentRecord[zone] += ms;
+}
+
+void Profiler::endRecord(ProfileTrack track) {
+    if (!isEnabled()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    float* slot = ring[track][records[track] % PROFILE_HISTORY];
+    for (int z = 0; z < PROF_ZONE_COUNT; z++) {
+        if (zoneTrack((ProfileZone)z) != track) continue;
+        slot[z] = (float)currentRecord[z];
+        currentRecord[z] = 0.0;
+    }
+    records[track]++;
+}
+
+void Profiler::history(ProfileZone zone, std::vector<float>& out) const {
+    ProfileTrack track = zoneTrack(zone);
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t count = std::min<uint64_t>(records[track], PROFILE_HISTORY);
+    out.resize((size_t)count);
+    for (uint64_t k = 0; k < count; k++) {
+        uint64_t record = records[track] - count + k;
+        out[k] = ring[track][record % PROFILE_HISTORY][zone];
+    }
+}
+
+ProfileStats Profiler::stats(ProfileZone zone) const {
+    std::vector<float> samples;
+    history(zone, samples);
+    ProfileStats s;
+    s.samples = (int)samples.size();
+    if (samples.empty()) return s;
+    s.last = samples.back();
+
+    // Rang le plus proche ; nth_element suffit (pas de tri complet)
+    auto at = [&](float q) {
+        size_t k = std::min(samples.size() - 1, (size_t)(q * (samples.size() - 1) + 0.5f));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    };
+    s.p50 = at(0.50f);
+    s.p99 = at(0.99f);
+    s.max = *std::max_element(samples.begin(), samples.end());
+    return s;
+}
+
+bool Profiler::dump(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        error = path + " : ecriture impossible";
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int t = 0; t < PROF_TRACK_COUNT; t++) {
+        out << (t == PROF_TRACK_SIM ? "piste,tick" : "piste,trame");
+        for (int z = 0; z < PROF_ZONE_COUNT; z++)
+            if (zoneTrack((ProfileZone)z) == t) out << "," << zoneName((ProfileZone)z) << " (ms)";
+        out << "\n";
+
+        uint64_t count = std::min<uint64_t>(records[t], PROFILE_HISTORY);
+        for (uint64_t record = records[t] - count; record < records[t]; record++) {
+            out << (t == PROF_TRACK_SIM ? "simulation," : "rendu,") << record;
+            for (int z = 0; z < PROF_ZONE_COUNT; z++)
+                if (zoneTrack((ProfileZone)z) == t) out << "," << ring[t][record % PROFILE_HISTORY][z];
+            out << "\n";
+        }
+    }
+    if (!out) {
+        error = path + " : ecriture impossible";
+        return false;
+    }
+    return true;
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int t = 0; t < PROF_TRACK_COUNT; t++) records[t] = 0;
+    for (double& c : currentRecord) c = 0.0;
+}
@@ -0,0 +1,153 @@
+#include "../include/Random.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SMARTCITY_SSE2 1
+#endif
+
+uint64_t Rng::next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int Rng::range(int min, int max) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    uint64_t span = (uint64_t)((int64_t)max - (int64_t)min) + 1;
+    return (int)((int64_t)min + (int64_t)(next() % span));
+}
+
+Rng& SimRng() {
+    static Rng rng;
+    return rng;
+}
+
+void SetSimSeed(uint64_t seed) {
+    SimRng().state = seed;
+}
+
+int SimRandomValue(int min, int max) {
+    return SimRng().range(min, max);
+}
+
+// Finaliseur de MurmurHash3 : chaque bit d'entrée influence tous les bits de sortie
+static inline uint32_t Fmix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Partie commune à tout un lot (graine, flux, poids fort du compteur)
+static inline uint32_t CounterBase(uint64_t seed, uint64_t counter, uint32_t stream) {
+    uint32_t h = Fmix32((uint32_t)seed ^ (stream * 0x9E3779B9u));
+    h = Fmix32(h ^ (uint32_t)(seed >> 32));
+    return Fmix32(h ^ (uint32_t)(counter >> 32));
+}
+
+// [0, 2^32) -> [min, max] par multiplication (pas de modulo, donc vectorisable)
+static inline void RangeBounds(int& min, int& max, uint64_t& span) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    span = (uint64_t)((int64_t)max - (int64_t)min) + 1;
+}
+
+uint32_t CounterHash(uint64_t seed, uint32_t key, uint64_t counter, uint32_t stream) {
+    uint32_t h = Fmix32(CounterBase(seed, counter, stream) ^ key);
+    return Fmix32(h ^ (uint32_t)counter);
+}
+
+int CounterRange(uint64_t seed, uint32_t key, uint64_t counter, uint32_t stream, int min, int max) {
+    uint64_t span;
+    RangeBounds(min, max, span);
+    uint64_t r = ((uint64_t)CounterHash(seed, key, counter, stream) * span) >> 32;
+    return (int)((int64_t)min + (int64_t)r);
+}
+
+#if defined(SMARTCITY_SSE2)
+// Produit 32 x 32 bits (poids faible), absent de SSE2
+static inline __m128i MulLo32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i Fmix32x4(__m128i h) {
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+    h = MulLo32(h, _mm_set1_epi32((int)0x85EBCA6Bu));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+    h = MulLo32(h, _mm_set1_epi32((int)0xC2B2AE35u));
+    return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+}
+#endif
+
+void CounterRangeBatch(uint64_t seed, const uint32_t* keys, size_t count, uint64_t counter,
+                       uint32_t stream, int min, int max, int32_t* out) {
+    uint64_t span;
+    RangeBounds(min, max, span);
+    const uint32_t base = CounterBase(seed, counter, stream);
+    const uint32_t low = (uint32_t)counter;
+    size_t i = 0;
+
+    // span <= 2^32 - 1 pour le calcul vectoriel (le multiplicateur tient sur 32 bits)
+    if (span <= 0xFFFFFFFFull) {
+#if defined(__AVX2__)
+        const __m256i vbase = _mm256_set1_epi32((int)base);
+        const __m256i vlow = _mm256_set1_epi32((int)low);
+        const __m256i vspan = _mm256_set1_epi32((int)(uint32_t)span);
+        const __m256i vmin = _mm256_set1_epi32(min);
+        const __m256i c1 = _mm256_set1_epi32((int)0x85EBCA6Bu);
+        const __m256i c2 = _mm256_set1_epi32((int)0xC2B2AE35u);
+        const __m256i hiMask = _mm256_set1_epi64x((long long)0xFFFFFFFF00000000ull);
+        for (; i + 8 <= count; i += 8) {
+            __m256i h = _mm256_xor_si256(vbase, _mm256_loadu_si256((const __m256i*)(keys + i)));
+            for (int round = 0; round < 2; round++) {
+                h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+                h = _mm256_mullo_epi32(h, c1);
+                h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+                h = _mm256_mullo_epi32(h, c2);
+                h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+                if (round == 0) h = _mm256_xor_si256(h, vlow);
+            }
+            // (h * span) >> 32 : voies paires puis impaires
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(h, vspan), 32);
+            __m256i odd = _mm256_and_si256(_mm256_mul_epu32(_mm256_srli_epi64(h, 32), vspan), hiMask);
+            __m256i r = _mm256_add_epi32(_mm256_or_si256(even, odd), vmin);
+            _mm256_storeu_si256((__m256i*)(out + i), r);
+        }
+#elif defined(SMARTCITY_SSE2)
+        const __m128i vbase = _mm_set1_epi32((int)base);
+        const __m128i vlow = _mm_set1_epi32((int)low);
+        const __m128i vspan = _mm_set1_epi32((int)(uint32_t)span);
+        const __m128i vmin = _mm_set1_epi32(min);
+        const __m128i hiMask = _mm_set1_epi64x((long long)0xFFFFFFFF00000000ull);
+        for (; i + 4 <= count; i += 4) {
+            __m128i h = _mm_xor_si128(vbase, _mm_loadu_si128((const __m128i*)(keys + i)));
+            h = Fmix32x4(_mm_xor_si128(Fmix32x4(h), vlow));
+            __m128i even = _mm_srli_epi64(_mm_mul_epu32(h, vspan), 32);
+            __m128i odd = _mm_and_si128(_mm_mul_epu32(_mm_srli_epi64(h, 32), vspan), hiMask);
+            __m128i r = _mm_add_epi32(_mm_or_si128(even, odd), vmin);
+            _mm_storeu_si128((__m128i*)(out + i), r);
+        }
+#endif
+    }
+
+    // Reste (ou plateforme sans SIMD)
+    for (; i < count; i++) {
+        uint32_t h = Fmix32(Fmix32(base ^ keys[i]) ^ low);
+        out[i] = (int32_t)((int64_t)min + (int64_t)(((uint64_t)h * span) >> 32));
+    }
+}
@@ -0,0 +1,270 @@
+#include "../include/Recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+const uint32_t TRAJECTORY_ENDIAN_TAG = 0x01020304u;
+const int TRAJECTORY_FIELDS = 5;    // x, y, vitesse, état, parkingIdx
+
+void TrajectoryFrame::resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+    speed.resize(n);
+    state.resize(n);
+    parkingIdx.resize(n);
+}
+
+// ---------------------------
+//  Codage : zigzag + varint (LEB128)
+// ---------------------------
+static inline uint32_t ZigZag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t UnZigZag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Écrit au plus 10 octets à partir de out (place réservée par l'appelant)
+static inline uint8_t* PutVarint(uint8_t* out, uint64_t v) {
+    while (v >= 0x80) {
+        *out++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = (uint8_t)v;
+    return out;
+}
+
+static inline bool GetVarint(const std::vector<uint8_t>& in, size_t& cursor, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && cursor < in.size(); shift += 7) {
+        uint8_t byte = in[cursor++];
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Valeur quantifiée (arrondi au plus proche), bornée pour rester dans un int32
+static inline int32_t Quantize(float v) {
+    float q = v * TRAJECTORY_SCALE;
+    if (!(q > -2.0e9f)) return (q != q) ? 0 : (int32_t)-2000000000;
+    if (q > 2.0e9f) return 2000000000;
+    return (int32_t)(q + (q >= 0.0f ? 0.5f : -0.5f));
+}
+
+// ---------------------------
+//  Enregistreur
+// ---------------------------
+bool TrajectoryRecorder::open(const std::string& path, std::string& error, int ringSlots, bool wait) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) { error = path + " : ecriture impossible"; return false; }
+
+    TrajectoryFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, TRAJECTORY_MAGIC, sizeof(h.magic));
+    h.version = TRAJECTORY_VERSION;
+    h.endianTag = TRAJECTORY_ENDIAN_TAG;
+    h.scale = TRAJECTORY_SCALE;
+    h.framesPerChunk = TRAJECTORY_FRAMES_PER_CHUNK;
+    file.write((const char*)&h, sizeof(h));
+
+    ring.assign(std::max(2, ringSlots), TrajectoryFrame());
+    head.store(0);
+    tail.store(0);
+    stopping.store(false);
+    waitWhenFull = wait;
+    chunkBytes = 0;
+    chunkFrames = 0;
+    previous.clear();
+    recorded.store(0);
+    dropped.store(0);
+    written.store(sizeof(h));
+
+    writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+    return true;
+}
+
+void TrajectoryRecorder::close() {
+    if (!writer.joinable()) return;
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    file.close();
+    ring.clear();
+}
+
+void TrajectoryRecorder::record(uint64_t tick, const std::vector<Car>& cars) {
+    TrajectoryFrame* frame = beginFrame(tick, cars.size());
+    if (!frame) return;
+    capture(*frame, cars, 0, cars.size());
+    publish();
+}
+
+TrajectoryFrame* TrajectoryRecorder::beginFrame(uint64_t tick, size_t carCount) {
+    if (!writer.joinable()) return nullptr;
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    const uint64_t slots = ring.size();
+    if (h - tail.load(std::memory_order_acquire) >= slots) {
+        // Anneau plein : le thread d'écriture a pris du retard
+        if (!waitWhenFull) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        while (h - tail.load(std::memory_order_acquire) >= slots) std::this_thread::yield();
+    }
+    TrajectoryFrame& frame = ring[h % slots];
+    frame.tick = tick;
+    frame.resize(carCount);
+    return &frame;
+}
+
+void TrajectoryRecorder::capture(TrajectoryFrame& frame, const std::vector<Car>& cars, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const Car& c = cars[i];
+        frame.x[i] = c.worldPos.x;
+        frame.y[i] = c.worldPos.y;
+        frame.speed[i] = c.speed;
+        frame.state[i] = (uint8_t)c.state;
+        frame.parkingIdx[i] = c.parkingIdx;
+    }
+}
+
+void TrajectoryRecorder::publish() {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    recorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TrajectoryRecorder::writerLoop() {
+    for (;;) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            // Plus rien à écrire : on s'arrête seulement si la simulation a fermé l'enregistrement
+            if (stopping.load(std::memory_order_acquire) && t == head.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        encodeFrame(ring[t % ring.size()]);
+        tail.store(t + 1, std::memory_order_release);
+        if (chunkFrames >= (uint32_t)TRAJECTORY_FRAMES_PER_CHUNK) flushChunk();
+    }
+    flushChunk();
+    file.flush();
+}
+
+void TrajectoryRecorder::encodeFrame(const TrajectoryFrame& frame) {
+    const size_t n = frame.size();
+    if (chunkFrames == 0) {
+        // Début de bloc : trame complète (delta par rapport à zéro)
+        chunkFirstTick = frame.tick;
+        lastTick = frame.tick;
+        previous.assign(n * TRAJECTORY_FIELDS, 0);
+    }
+    previous.resize(n * TRAJECTORY_FIELDS, 0);   // voitures ajoutées : delta par rapport à zéro
+
+    // Place maximale de la trame (10 octets par varint), puis écriture directe
+    // (le tampon ne fait que grandir : pas de remise à zéro à chaque trame)
+    const size_t need = chunkBytes + 20 + n * TRAJECTORY_FIELDS * 5;
+    if (chunk.size() < need) chunk.resize(std::max(need, chunk.size() * 2));
+    uint8_t* out = chunk.data() + chunkBytes;
+    out = PutVarint(out, frame.tick - lastTick);
+    out = PutVarint(out, n);
+    int32_t* prev = previous.data();
+    for (size_t i = 0; i < n; i++, prev += TRAJECTORY_FIELDS) {
+        const int32_t values[TRAJECTORY_FIELDS] = {Quantize(frame.x[i]), Quantize(frame.y[i]),
+                                                   Quantize(frame.speed[i]), frame.state[i],
+                                                   frame.parkingIdx[i]};
+        for (int f = 0; f < TRAJECTORY_FIELDS; f++) {
+            out = PutVarint(out, ZigZag((int32_t)((uint32_t)values[f] - (uint32_t)prev[f])));
+            prev[f] = values[f];
+        }
+    }
+    chunkBytes = (size_t)(out - chunk.data());
+    lastTick = frame.tick;
+    chunkFrames++;
+}
+
+void TrajectoryRecorder::flushChunk() {
+    if (chunkFrames == 0) return;
+    TrajectoryChunkHeader h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = TRAJECTORY_CHUNK_MAGIC;
+    h.frameCount = chunkFrames;
+    h.firstTick = chunkFirstTick;
+    h.payloadSize = chunkBytes;
+    file.write((const char*)&h, sizeof(h));
+    file.write((const char*)chunk.data(), (std::streamsize)chunkBytes);
+    written.fetch_add(sizeof(h) + chunkBytes, std::memory_order_relaxed);
+    chunkBytes = 0;
+    chunkFrames = 0;
+}
+
+// ---------------------------
+//  Relecture
+// ---------------------------
+bool TrajectoryReader::open(const std::string& path, std::string& error) {
+    file.open(path, std::ios::binary);
+    if (!file) { error = path + " : ouverture impossible"; return false; }
+    TrajectoryFileHeader h;
+    if (!file.read((char*)&h, sizeof(h)) || std::memcmp(h.magic, TRAJECTORY_MAGIC, sizeof(h.magic)) != 0) {
+        error = path + " : pas un fichier de trajectoires";
+        return false;
+    }
+    if (h.version != TRAJECTORY_VERSION || h.endianTag != TRAJECTORY_ENDIAN_TAG || !(h.scale > 0.0f)) {
+        error = path + " : version ou boutisme non supporte";
+        return false;
+    }
+    scale = h.scale;
+    framesLeft = 0;
+    return true;
+}
+
+bool TrajectoryReader::loadChunk() {
+    TrajectoryChunkHeader h;
+    if (!file.read((char*)&h, sizeof(h))) return false;   // fin de fichier
+    if (h.magic != TRAJECTORY_CHUNK_MAGIC || h.frameCount == 0) {
+        lastError = "bloc corrompu";
+        return false;
+    }
+    chunk.resize((size_t)h.payloadSize);
+    if (!file.read((char*)chunk.data(), (std::streamsize)chunk.size())) {
+        lastError = "bloc tronque";
+        return false;
+    }
+    cursor = 0;
+    framesLeft = h.frameCount;
+    tick = h.firstTick;
+    previous.clear();
+    return true;
+}
+
+bool TrajectoryReader::next(TrajectoryFrame& frame) {
+    if (framesLeft == 0 && !loadChunk()) return false;
+
+    uint64_t delta, n;
+    if (!GetVarint(chunk, cursor, delta) || !GetVarint(chunk, cursor, n) ||
+        n > (chunk.size() - cursor) / TRAJECTORY_FIELDS) {
+        lastError = "trame corrompue";
+        return false;
+    }
+    tick += delta;
+    previous.resize((size_t)n * TRAJECTORY_FIELDS, 0);
+    frame.tick = tick;
+    frame.resize((size_t)n);
+
+    int32_t* prev = previous.data();
+    const float inv = 1.0f / scale;
+    for (size_t i = 0; i < n; i++, prev += TRAJECTORY_FIELDS) {
+        for (int f = 0; f < TRAJECTORY_FIELDS; f++) {
+            uint64_t v;
+            if (!GetVarint(chunk, cursor, v)) {
+                lastError = "trame corrompue";
+                return false;
+            }
+            prev[f] = (int32_t)((uint32_t)prev[f] + (uint32_t)UnZigZag((uint32_t)v));
+        }
+        frame.x[i] = prev[0] * inv;
+        frame.y[i] = prev[1] * inv;
+        frame.speed[i] = prev[2] * inv;
+        frame.state[i] = (uint8_t)prev[3];
+        frame.parkingIdx[i] = prev[4];
+    }
+    framesLeft--;
+    return true;
+}
@@ -0,0 +1,183 @@
+#include "../include/RoadNetwork.hpp"
+#include "../include/Random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+// Union-find sur les extrémités des routes (2*s : début, 2*s+1 : fin)
+static int FindRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+static void Union(std::vector<int>& parent, int a, int b) {
+    a = FindRoot(parent, a);
+    b = FindRoot(parent, b);
+    if (a != b) parent[std::max(a, b)] = std::min(a, b);
+}
+
+// Distance d'un point au segment [start, end]
+static float DistanceToSegment(const RoadSegment& s, Vec2 p) {
+    float t = std::max(0.0f, std::min(s.length, s.project(p)));
+    return Vec2Distance(p, s.pointAt(t, 0.0f));
+}
+
+void RoadNetwork::build(const std::vector<Road>& roads, const std::vector<ParkingLot>& parkings) {
+    const int count = (int)roads.size();
+    segments.assign(count, RoadSegment());
+    explicitNext.assign(count, -1);
+
+    // 1. Géométrie précalculée
+    for (int s = 0; s < count; s++) {
+        const Road& road = roads[s];
+        RoadSegment& seg = segments[s];
+        seg.start = road.start;
+        seg.end = road.end;
+        seg.length = road.getLength();
+        seg.dir = road.getDir();
+        seg.normal = { -seg.dir.y, seg.dir.x };
+        seg.heading = std::atan2(seg.dir.y, seg.dir.x) * 57.29578f;
+        if (seg.heading < 0.0f) seg.heading += 360.0f;
+        seg.lanes = std::max(1, road.lanes);
+        seg.laneWidth = road.width / seg.lanes;
+        seg.firstLaneOffset = -road.width / 2 + seg.laneWidth / 2;
+        if (road.next >= 0 && road.next < count) explicitNext[s] = road.next;
+    }
+
+    // 2. Fusion des extrémités proches (grille de hachage de pas NODE_TOLERANCE)
+    std::vector<int> parent(2 * count);
+    for (int e = 0; e < 2 * count; e++) parent[e] = e;
+    auto endpoint = [&](int e) { return (e % 2 == 0) ? segments[e / 2].start : segments[e / 2].end; };
+    auto cellKey = [](long long cx, long long cy) { return (uint64_t)(cx * 73856093LL) ^ (uint64_t)(cy * 19349663LL); };
+
+    std::unordered_map<uint64_t, std::vector<int>> grid;
+    for (int e = 0; e < 2 * count; e++) {
+        Vec2 p = endpoint(e);
+        long long cx = (long long)std::floor(p.x / NODE_TOLERANCE);
+        long long cy = (long long)std::floor(p.y / NODE_TOLERANCE);
+        for (long long dx = -1; dx <= 1; dx++) {
+            for (long long dy = -1; dy <= 1; dy++) {
+                auto it = grid.find(cellKey(cx + dx, cy + dy));
+                if (it == grid.end()) continue;
+                for (int other : it->second) {
+                    if (Vec2Distance(p, endpoint(other)) < NODE_TOLERANCE) Union(parent, e, other);
+                }
+            }
+        }
+        grid[cellKey(cx, cy)].push_back(e);
+    }
+
+    // 3. Liens explicites : la fin d'une route et le début de la suivante forment un noeud
+    for (int s = 0; s < count; s++) {
+        if (explicitNext[s] >= 0) Union(parent, 2 * s + 1, 2 * explicitNext[s]);
+    }
+
+    // 4. Numérotation des noeuds (dans l'ordre des routes)
+    nodes.clear();
+    std::vector<int> nodeOf(2 * count, -1);
+    for (int e = 0; e < 2 * count; e++) {
+        int root = FindRoot(parent, e);
+        if (nodeOf[root] < 0) {
+            nodeOf[root] = (int)nodes.size();
+            RoadNode node;
+            node.position = endpoint(e);
+            nodes.push_back(node);
+        }
+        nodeOf[e] = nodeOf[root];
+    }
+    for (int s = 0; s < count; s++) {
+        segments[s].from = nodeOf[2 * s];
+        segments[s].to = nodeOf[2 * s + 1];
+        nodes[segments[s].from].outgoing.push_back(s);
+        nodes[segments[s].to].incoming.push_back(s);
+    }
+
+    // 5. Accès aux parkings
+    laneLotsBase.assign(count + 1, 0);
+    for (int s = 0; s < count; s++) laneLotsBase[s + 1] = laneLotsBase[s] + segments[s].lanes;
+    laneLots.assign(laneLotsBase[count], std::vector<int>());
+
+    const int lotCount = (int)parkings.size();
+    lotRoads.assign(lotCount, -1);
+    lotLanes.assign(lotCount, -1);
+    lotEntrances.assign(lotCount, 0.0f);
+    for (int p = 0; p < lotCount; p++) {
+        const ParkingLot& lot = parkings[p];
+        int road = lot.roadIndex;
+        if (road < 0 || road >= count) {
+            // Route la plus proche de la sortie du parking
+            road = -1;
+            float best = std::numeric_limits<float>::max();
+            for (int s = 0; s < count; s++) {
+                float d = DistanceToSegment(segments[s], lot.exitPos);
+                if (d < best) {
+                    best = d;
+                    road = s;
+                }
+            }
+        }
+        if (road < 0) continue;
+
+        const RoadSegment& seg = segments[road];
+        Vec2 center = { lot.position.x + lot.size.x / 2, lot.position.y + lot.size.y / 2 };
+        int lane = lot.lane;
+        if (lane < 0 || lane >= seg.lanes) {
+            // Voie extérieure, du côté où se trouve le parking
+            lane = (seg.sideOffset(center) < 0.0f) ? 0 : seg.lanes - 1;
+        }
+
+        lotRoads[p] = road;
+        lotLanes[p] = lane;
+        lotEntrances[p] = seg.project(center);
+        laneLots[laneLotsBase[road] + lane].push_back(p);
+    }
+
+    built = true;
+}
+
+bool RoadNetwork::uTurn(int from, int to) const {
+    return segments[to].to == segments[from].from && segments[to].from == segments[from].to;
+}
+
+int RoadNetwork::successor(int idx, uint32_t carId, uint64_t seed, uint64_t tick) const {
+    if (explicitNext[idx] >= 0) return explicitNext[idx];
+
+    const std::vector<int>& out = nodes[segments[idx].to].outgoing;
+
+    // Demi-tour (route inverse) seulement s'il n'y a pas d'autre choix. Deux passes sur les
+    // sorties (compte, puis la k-ième) : aucune limite au nombre de routes d'un carrefour
+    int n = 0;
+    for (int s : out) n += !uTurn(idx, s);
+    if (n == 0) return out.empty() ? idx : out[0];
+    int pick = (n == 1) ? 0 : CounterRange(seed, carId, tick, DRAW_TURN, 0, n - 1);
+    for (int s : out) {
+        if (!uTurn(idx, s) && pick-- == 0) return s;
+    }
+    return idx;
+}
+
+int RoadNetwork::forcedSuccessor(int idx) const {
+    if (explicitNext[idx] >= 0) return explicitNext[idx];
+    const std::vector<int>& out = nodes[segments[idx].to].outgoing;
+    int only = -1, n = 0;
+    for (int s : out) {
+        if (uTurn(idx, s)) continue;
+        only = s;
+        n++;
+    }
+    if (n == 0) return out.empty() ? idx : out[0];
+    return (n == 1) ? only : -1;
+}
+
+bool RoadNetwork::continuous(int from, int to) const {
+    return Vec2Distance(segments[from].end, segments[to].start) < NODE_TOLERANCE;
+}
+
+const std::vector<int>& RoadNetwork::lotsOnLane(int road, int lane) const {
+    if (road < 0 || road >= (int)segments.size() || lane < 0 || lane >= segments[road].lanes) return noLots;
+    return laneLots[laneLotsBase[road] + lane];
+}
@@ -0,0 +1,420 @@
+#include "../include/Scenario.hpp"
+#include "../include/ParkingLogic.hpp"
+#include "../include/Random.hpp"
+#include "../include/SignalController.hpp"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<Road>::value, "Road est stockee telle quelle dans les .scb");
+static_assert(std::is_trivially_copyable<Car>::value, "Car est stockee telle quelle dans les .scb");
+
+const float FLEET_SPACING = 100.0f;   // espacement des voitures générées par "fleet"
+
+static uint64_t AlignUp(uint64_t v) { return (v + SCENARIO_ALIGN - 1) & ~(SCENARIO_ALIGN - 1); }
+
+// count enregistrements de size octets tiennent entre offset et end (offset <= end vérifié
+// avant la soustraction : aucune somme ne peut déborder)
+static bool BlockFits(uint64_t offset, uint64_t count, uint64_t size, uint64_t end) {
+    return offset <= end && count <= (end - offset) / size;
+}
+
+// Décalage latéral d'une voie (même convention que le réseau routier)
+static float LaneOffsetOf(const Road& road, int lane) {
+    float laneWidth = road.width / road.lanes;
+    return -road.width / 2 + (lane + 0.5f) * laneWidth;
+}
+
+// Vérifie chaque voiture de la flotte (ValidCar) et marque les places déjà prises
+static bool AttachFleet(const std::vector<Road>& roads, std::vector<ParkingLot>& parkings,
+                        const std::vector<Car>& cars, std::string& error) {
+    for (size_t i = 0; i < cars.size(); i++) {
+        const Car& c = cars[i];
+        if (!ValidCar(c, roads, parkings)) {
+            error = "voiture " + std::to_string(i) + " : etat, route, voie, parking ou place invalide";
+            return false;
+        }
+        if (c.parkingIdx >= 0 && c.spotIdx >= 0) parkings[c.parkingIdx].occupySpot(c.spotIdx);
+    }
+    return true;
+}
+
+// ---------------------------
+//  Projection mémoire
+// ---------------------------
+MappedScenario::MappedScenario(MappedScenario&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedScenario& MappedScenario::operator=(MappedScenario&& other) noexcept {
+    if (this != &other) {
+        close();
+        data = other.data;
+        length = other.length;
+        other.data = nullptr;
+        other.length = 0;
+#if defined(_WIN32)
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+        other.fileHandle = nullptr;
+        other.mappingHandle = nullptr;
+#endif
+    }
+    return *this;
+}
+
+void MappedScenario::close() {
+#if defined(_WIN32)
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data) munmap((void*)data, length);
+#endif
+    data = nullptr;
+    length = 0;
+}
+
+bool MappedScenario::open(const std::string& path, std::string& error) {
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { error = path + " : ouverture impossible"; return false; }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(ScenarioHeader)) {
+        CloseHandle(file);
+        error = path + " : fichier trop court";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = path + " : projection impossible";
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = (const unsigned char*)view;
+    length = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { error = path + " : ouverture impossible"; return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ScenarioHeader)) {
+        ::close(fd);
+        error = path + " : fichier trop court";
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // la projection reste valide sans le descripteur
+    if (view == MAP_FAILED) { error = path + " : projection impossible"; return false; }
+    data = (const unsigned char*)view;
+    length = (size_t)st.st_size;
+#endif
+
+    // En-tête et bornes des blocs (le contenu des voitures est vérifié à l'instanciation)
+    const ScenarioHeader& h = header();
+    const char* problem = nullptr;
+    if (std::memcmp(h.magic, SCENARIO_MAGIC, sizeof(h.magic)) != 0) problem = "pas un scenario binaire";
+    else if (h.version != SCENARIO_VERSION) problem = "version non supportee";
+    else if (h.endianTag != SCENARIO_ENDIAN_TAG) problem = "boutisme different";
+    else if (h.roadSize != sizeof(Road) || h.lotSize != sizeof(ScenarioLotRecord) || h.carSize != sizeof(Car))
+        problem = "disposition des enregistrements differente (recompiler le scenario)";
+    else if (h.fileSize != length) problem = "taille incoherente (fichier tronque ?)";
+    else if (h.roadsOffset % SCENARIO_ALIGN || h.lotsOffset % SCENARIO_ALIGN || h.carsOffset % SCENARIO_ALIGN)
+        problem = "blocs mal alignes";
+    // Blocs dans l'ordre de l'en-tête, chacun avant le suivant, les noms jusqu'à la fin
+    else if (h.roadsOffset < sizeof(ScenarioHeader) || h.namesOffset > length ||
+             !BlockFits(h.roadsOffset, h.roadCount, sizeof(Road), h.lotsOffset) ||
+             !BlockFits(h.lotsOffset, h.lotCount, sizeof(ScenarioLotRecord), h.carsOffset) ||
+             !BlockFits(h.carsOffset, h.carCount, sizeof(Car), h.namesOffset) ||
+             h.namesSize != length - h.namesOffset || h.namesSize == 0)
+        problem = "blocs hors du fichier";
+    else if (data[length - 1] != '\0') problem = "bloc des noms non termine";
+
+    for (size_t i = 0; !problem && i < roadCount(); i++) {
+        const Road& r = roads()[i];
+        if (r.lanes < 1 || r.next < -1 || r.next >= (int)roadCount()) problem = "route invalide";
+    }
+    for (size_t i = 0; !problem && i < lotCount(); i++) {
+        const ScenarioLotRecord& l = lots()[i];
+        if (l.capacity < 0 || l.nameOffset >= h.namesSize || l.roadIndex >= (int)roadCount()) problem = "parking invalide";
+    }
+
+    if (problem) {
+        error = path + " : " + problem;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedScenario::instantiate(std::vector<Road>& outRoads, std::vector<ParkingLot>& outParkings,
+                                 std::vector<Car>& outCars, std::string& error) const {
+    outRoads.assign(roads(), roads() + roadCount());
+
+    outParkings.clear();
+    outParkings.reserve(lotCount());
+    for (size_t i = 0; i < lotCount(); i++) {
+        const ScenarioLotRecord& l = lots()[i];
+        outParkings.push_back(ParkingLot(l.position, l.size, l.capacity, l.price, lotName(i), l.color, l.exitPos));
+        outParkings.back().roadIndex = l.roadIndex;
+        outParkings.back().lane = l.lane;
+    }
+
+    // Car est trivialement copiable : copie en bloc (memmove), sans construction élément par élément
+    outCars.assign(cars(), cars() + carCount());
+    return AttachFleet(outRoads, outParkings, outCars, error);
+}
+
+// ---------------------------
+//  Écriture binaire
+// ---------------------------
+bool SaveScenarioBinary(const std::string& path, uint64_t seed, const std::vector<Road>& roads,
+                        const std::vector<ParkingLot>& parkings, const std::vector<Car>& cars,
+                        std::string& error) {
+    ScenarioHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, SCENARIO_MAGIC, sizeof(h.magic));
+    h.version = SCENARIO_VERSION;
+    h.endianTag = SCENARIO_ENDIAN_TAG;
+    h.roadSize = sizeof(Road);
+    h.lotSize = sizeof(ScenarioLotRecord);
+    h.carSize = sizeof(Car);
+    h.roadCount = (uint32_t)roads.size();
+    h.lotCount = (uint32_t)parkings.size();
+    h.carCount = cars.size();
+    h.seed = seed;
+
+    std::vector<ScenarioLotRecord> lots(parkings.size());
+    std::string names;
+    for (size_t i = 0; i < parkings.size(); i++) {
+        const ParkingLot& p = parkings[i];
+        ScenarioLotRecord& l = lots[i];
+        std::memset(&l, 0, sizeof(l));
+        l.position = p.position;
+        l.size = p.size;
+        l.capacity = p.capacity;
+        l.price = p.basePrice;
+        l.color = p.color;
+        l.exitPos = p.exitPos;
+        l.roadIndex = p.roadIndex;
+        l.lane = p.lane;
+        l.nameOffset = (uint32_t)names.size();
+        names += p.name ? p.name : "";
+        names += '\0';
+    }
+    if (names.empty()) names += '\0';
+
+    h.roadsOffset = AlignUp(sizeof(ScenarioHeader));
+    h.lotsOffset = AlignUp(h.roadsOffset + roads.size() * sizeof(Road));
+    h.carsOffset = AlignUp(h.lotsOffset + lots.size() * sizeof(ScenarioLotRecord));
+    h.namesOffset = h.carsOffset + cars.size() * sizeof(Car);
+    h.namesSize = names.size();
+    h.fileSize = h.namesOffset + h.namesSize;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) { error = path + " : ecriture impossible"; return false; }
+
+    const char zeros[SCENARIO_ALIGN] = {};
+    auto padTo = [&](uint64_t offset) {
+        uint64_t pos = (uint64_t)out.tellp();
+        if (offset > pos) out.write(zeros, (std::streamsize)(offset - pos));
+    };
+    out.write((const char*)&h, sizeof(h));
+    padTo(h.roadsOffset);
+    out.write((const char*)roads.data(), (std::streamsize)(roads.size() * sizeof(Road)));
+    padTo(h.lotsOffset);
+    out.write((const char*)lots.data(), (std::streamsize)(lots.size() * sizeof(ScenarioLotRecord)));
+    padTo(h.carsOffset);
+    out.write((const char*)cars.data(), (std::streamsize)(cars.size() * sizeof(Car)));
+    out.write(names.data(), (std::streamsize)names.size());
+
+    if (!out) { error = path + " : ecriture incomplete"; return false; }
+    return true;
+}
+
+// ---------------------------
+//  Lecture texte
+// ---------------------------
+static bool ParseLight(const std::string& token, LightState& light) {
+    if (token == "G") light = LIGHT_GREEN;
+    else if (token == "Y") light = LIGHT_YELLOW;
+    else if (token == "R") light = LIGHT_RED;
+    else return false;
+    return true;
+}
+
+static bool ReadColor(std::istringstream& in, Rgba& color) {
+    int r, g, b, a;
+    if (!(in >> r >> g >> b >> a)) return false;
+    color = {(unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a};
+    return true;
+}
+
+// Flotte générée comme dans main.cpp : réparties en parts égales sur les routes,
+// voie tirée avec le générateur partagé, couleurs en alternance
+static void GenerateFleet(Scenario& out, int count, float speed) {
+    const Rgba palette[3] = {{230, 41, 55, 255}, {0, 121, 241, 255}, {0, 117, 44, 255}};
+    int nbRoads = (int)out.roads.size();
+    out.cars.reserve(out.cars.size() + count);
+    int firstId = (int)out.cars.size();
+    for (int i = 0; i < count; i++) {
+        int road = (int)((int64_t)i * nbRoads / count);
+        int firstOnRoad = (int)(((int64_t)road * count + nbRoads - 1) / nbRoads);
+        const Road& r = out.roads[road];
+
+        Car c;
+        c.id = firstId + i;
+        c.roadIndex = road;
+        c.currentLane = SimRandomValue(0, r.lanes - 1);
+        c.targetLane = c.currentLane;
+        c.distance = (i - firstOnRoad) * FLEET_SPACING;
+        c.speed = speed;
+        c.color = palette[i % 3];
+        c.laneOffset = LaneOffsetOf(r, c.currentLane);
+        out.cars.push_back(c);
+    }
+}
+
+bool LoadScenarioText(const std::string& path, Scenario& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file) { error = path + " : ouverture impossible"; return false; }
+
+    out = Scenario();
+    std::string line;
+    int lineNo = 0;
+    auto fail = [&](const std::string& message) {
+        error = path + ":" + std::to_string(lineNo) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(file, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword)) continue;
+
+        if (keyword == "seed") {
+            if (!(in >> out.seed)) return fail("graine attendue");
+            SetSimSeed(out.seed);
+        } else if (keyword == "road") {
+            Road r;
+            std::string light;
+            float timer;
+            if (!(in >> r.start.x >> r.start.y >> r.end.x >> r.end.y >> r.lanes >> r.width >> light >> timer))
+                return fail("road x0 y0 x1 y1 voies largeur feu minuterie [suivante]");
+            if (r.lanes < 1 || r.width <= 0.0f) return fail("voies et largeur doivent etre positives");
+            r.light = {r.end, LIGHT_GREEN, timer};
+            if (!ParseLight(light, r.light.state)) return fail("feu : G, Y ou R");
+            if (!(in >> r.next)) r.next = -1;
+            out.roads.push_back(r);
+        } else if (keyword == "signal") {
+            int road;
+            std::string mode;
+            SignalPlan plan;
+            if (!(in >> road >> mode >> plan.cycle >> plan.green >> plan.yellow))
+                return fail("signal route fixe|adaptatif cycle vert jaune");
+            if (road < 0 || road >= (int)out.roads.size()) return fail("route inconnue (declarer les routes avant)");
+            if (mode == "fixe") plan.mode = SIGNAL_FIXED;
+            else if (mode == "adaptatif") plan.mode = SIGNAL_ACTUATED;
+            else return fail("mode de feu : fixe ou adaptatif");
+            if (plan.green <= 0.0f || plan.yellow < 0.0f || plan.cycle < plan.green + plan.yellow)
+                return fail("feu : vert > 0, jaune >= 0, cycle >= vert + jaune");
+            out.roads[road].signal = plan;
+        } else if (keyword == "wave") {
+            float speed;
+            std::vector<int> corridor;
+            if (!(in >> speed) || speed <= 0.0f) return fail("wave vitesse route route ...");
+            for (int road; in >> road;) {
+                if (road < 0 || road >= (int)out.roads.size()) return fail("route inconnue (declarer les routes avant)");
+                corridor.push_back(road);
+            }
+            if (corridor.empty()) return fail("wave : au moins une route");
+            ApplyGreenWave(out.roads, corridor, speed);
+        } else if (keyword == "parking") {
+            std::string name;
+            Vec2 pos, size, exit;
+            int capacity;
+            float price;
+            Rgba color;
+            if (!(in >> name >> pos.x >> pos.y >> size.x >> size.y >> capacity >> price) ||
+                !ReadColor(in, color) || !(in >> exit.x >> exit.y))
+                return fail("parking nom x y l h places prix r g b a sortieX sortieY [route voie]");
+            if (capacity < 0) return fail("nombre de places negatif");
+            out.names.push_back(name);
+            ParkingLot p(pos, size, capacity, price, out.names.back().c_str(), color, exit);
+            if (in >> p.roadIndex) {
+                if (!(in >> p.lane)) return fail("voie d'acces attendue apres la route");
+            }
+            out.parkings.push_back(p);
+        } else if (keyword == "car") {
+            Car c;
+            if (!(in >> c.roadIndex >> c.currentLane >> c.distance >> c.speed))
+                return fail("car route voie distance vitesse [r g b a]");
+            if (c.roadIndex < 0 || c.roadIndex >= (int)out.roads.size()) return fail("route inconnue (declarer les routes avant)");
+            const Road& r = out.roads[c.roadIndex];
+            if (c.currentLane < 0 || c.currentLane >= r.lanes) return fail("voie hors de la route");
+            Rgba color;
+            if (ReadColor(in, color)) c.color = color;
+            c.id = (int)out.cars.size();
+            c.targetLane = c.currentLane;
+            c.laneOffset = LaneOffsetOf(r, c.currentLane);
+            out.cars.push_back(c);
+        } else if (keyword == "fleet") {
+            int count;
+            float speed = MAX_SPEED;
+            if (!(in >> count) || count < 0) return fail("fleet nombre [vitesse]");
+            in >> speed;
+            if (out.roads.empty()) return fail("fleet sans route (declarer les routes avant)");
+            GenerateFleet(out, count, speed);
+        } else {
+            return fail("mot-cle inconnu '" + keyword + "'");
+        }
+    }
+
+    for (const Road& r : out.roads) {
+        if (r.next >= (int)out.roads.size()) { error = path + " : route suivante inexistante"; return false; }
+    }
+    for (const ParkingLot& p : out.parkings) {
+        if (p.roadIndex >= (int)out.roads.size()) { error = path + " : route d'acces inexistante"; return false; }
+    }
+    if (!AttachFleet(out.roads, out.parkings, out.cars, error)) { error = path + " : " + error; return false; }
+    return true;
+}
+
+bool LoadScenario(const std::string& path, Scenario& out, std::string& error) {
+    char magic[sizeof(SCENARIO_MAGIC)] = {};
+    {
+        std::ifstream probe(path, std::ios::binary);
+        if (!probe) { error = path + " : ouverture impossible"; return false; }
+        probe.read(magic, sizeof(magic));
+    }
+    if (std::memcmp(magic, SCENARIO_MAGIC, sizeof(magic)) != 0) return LoadScenarioText(path, out, error);
+
+    out = Scenario();
+    if (!out.mapping.open(path, error)) return false;
+    out.seed = out.mapping.seed();
+    if (!out.mapping.instantiate(out.roads, out.parkings, out.cars, error)) {
+        error = path + " : " + error;
+        return false;
+    }
+    return true;
+}
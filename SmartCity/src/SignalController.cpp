@@ -0,0 +1,222 @@
+#include "../include/SignalController.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// Position d'un feu par rapport au début de son vert, déduite de son état et de sa minuterie
+// (la phase en cours est bornée à sa durée dans le plan)
+static float PhasePosition(const TrafficLight& light, float cycle, float green, float yellow) {
+    float red = cycle - green - yellow;
+    if (light.state == LIGHT_GREEN) return green - std::min(std::max(light.timer, 0.0f), green);
+    if (light.state == LIGHT_YELLOW) return green + yellow - std::min(std::max(light.timer, 0.0f), yellow);
+    return cycle - std::min(std::max(light.timer, 0.0f), red);
+}
+
+// Ramène x dans [0, period[
+static double Wrap(double x, double period) {
+    double r = std::fmod(x, period);
+    return (r < 0.0) ? r + period : r;
+}
+
+void SignalController::build(std::vector<Road>& roads, const RoadNetwork& network) {
+    const int n = (int)roads.size();
+    heads.assign(n, SignalHead());
+    junctions.clear();
+
+    // Carrefours adaptatifs : feux adaptatifs regroupés par noeud d'arrivée (ordre des routes)
+    std::map<int, int> actuatedAtNode;
+    for (int r = 0; r < n; r++) {
+        const SignalPlan& plan = roads[r].signal;
+        SignalHead& head = heads[r];
+        head.road = r;
+        head.greenTime = std::max(plan.green, 0.0f);
+        head.yellow = std::max(plan.yellow, 0.0f);
+        head.stopLine = roads[r].getLength() - SIGNAL_STOP_OFFSET;
+        float cycle = std::max(plan.cycle, head.greenTime + head.yellow);
+
+        int node = (plan.mode == SIGNAL_ACTUATED && r < network.segmentCount()) ? network.segment(r).to : -1;
+        auto found = actuatedAtNode.find(node);
+        if (node >= 0 && found != actuatedAtNode.end()) {
+            head.junction = found->second;
+            junctions[head.junction].heads.push_back(r);
+            continue;
+        }
+
+        // Premier feu du carrefour : son vert ouvre le cycle
+        SignalJunction junction;
+        junction.actuated = node >= 0;
+        junction.cycle = cycle;
+        junction.cycleStart = time - PhasePosition(roads[r].light, cycle, head.greenTime, head.yellow);
+        junction.heads.push_back(r);
+        head.junction = (int)junctions.size();
+        if (node >= 0) actuatedAtNode[node] = head.junction;
+        junctions.push_back(junction);
+    }
+
+    // Premier cycle des carrefours adaptatifs : verts nominaux, en séquence
+    for (int j = 0; j < (int)junctions.size(); j++) {
+        if (junctions[j].actuated) planJunction(j, roads, std::vector<Car>(), nullptr);
+    }
+    // État de chaque feu (inchangé pour un feu fixe) et prochain changement
+    events = decltype(events)();
+    for (int j = 0; j < (int)junctions.size(); j++) {
+        if (junctions[j].actuated) events.push({junctions[j].cycleStart + junctions[j].cycle, j});
+    }
+    for (int h = 0; h < n; h++) evaluate(h, roads);
+    built = true;
+}
+
+// Verts du cycle qui commence : besoin de chaque feu (vert minimal + temps d'écoulement de
+// sa file, ou vert nominal au premier cycle), ramené à la place disponible dans le cycle
+void SignalController::planJunction(int j, const std::vector<Road>& roads, const std::vector<Car>& cars,
+                                    const LaneIndex* index) {
+    SignalJunction& junction = junctions[j];
+    const int count = (int)junction.heads.size();
+
+    float yellows = 0.0f;
+    for (int h : junction.heads) yellows += heads[h].yellow;
+    float available = junction.cycle - yellows - (count == 1 ? SIGNAL_MIN_RED : 0.0f);
+    available = std::max(available, 0.0f);
+    float minGreen = std::min(SIGNAL_MIN_GREEN, available / count);
+
+    std::vector<float> need(count);
+    float total = 0.0f;
+    for (int k = 0; k < count; k++) {
+        SignalHead& head = heads[junction.heads[k]];
+        if (index) {
+            // File : voitures lentes avant la ligne d'arrêt, voie la plus chargée
+            head.queue = 0;
+            for (int lane = 0; lane < roads[head.road].lanes; lane++) {
+                int queued = 0;
+                index->forEachInRange(head.road, lane, head.stopLine - SIGNAL_QUEUE_RANGE, head.stopLine,
+                                      [&](int carIdx, float) {
+                    if (cars[carIdx].state == DRIVING && cars[carIdx].speed < SIGNAL_QUEUE_SPEED) queued++;
+                    return true;
+                });
+                head.queue = std::max(head.queue, queued);
+            }
+            need[k] = SIGNAL_MIN_GREEN + SIGNAL_DISCHARGE_HEADWAY * head.queue;
+        } else {
+            need[k] = roads[head.road].signal.green;
+        }
+        need[k] = std::max(need[k], minGreen);
+        total += need[k];
+    }
+
+    // Trop de demande : chacun garde le vert minimal, le reste au prorata du besoin au-delà.
+    // Sinon, à plusieurs feux le temps libre est partagé au prorata ; un feu seul le laisse
+    // au trafic transversal.
+    float start = 0.0f;
+    for (int k = 0; k < count; k++) {
+        float green = need[k];
+        if (total > available) {
+            float above = total - count * minGreen;
+            green = minGreen + (above > 0.0f ? (available - count * minGreen) * (need[k] - minGreen) / above : 0.0f);
+        } else if (count > 1) {
+            green = need[k] + (available - total) * need[k] / total;
+        }
+        SignalHead& head = heads[junction.heads[k]];
+        head.greenStart = start;
+        head.greenTime = green;
+        start += green + head.yellow;
+    }
+}
+
+// État du feu au temps courant ; renvoie le temps restant avant le prochain changement
+double SignalController::phaseAt(int h, LightState& state) const {
+    const SignalHead& head = heads[h];
+    const SignalJunction& junction = junctions[head.junction];
+    double rel = Wrap(time - junction.cycleStart - head.greenStart, junction.cycle);
+    if (rel < head.greenTime) {
+        state = LIGHT_GREEN;
+        return head.greenTime - rel;
+    }
+    if (rel < head.greenTime + head.yellow) {
+        state = LIGHT_YELLOW;
+        return head.greenTime + head.yellow - rel;
+    }
+    state = LIGHT_RED;
+    return junction.cycle - rel;
+}
+
+void SignalController::evaluate(int h, std::vector<Road>& roads) {
+    SignalHead& head = heads[h];
+    LightState state;
+    double remaining = phaseAt(h, state);
+    TrafficLight& light = roads[head.road].light;
+    light.state = state;
+    light.timer = (float)remaining;
+    head.nextSwitch = time + remaining;
+    events.push({head.nextSwitch, (int)junctions.size() + h});
+}
+
+void SignalController::rebuildQueue() {
+    events = decltype(events)();
+    for (int j = 0; j < (int)junctions.size(); j++) {
+        if (junctions[j].actuated) events.push({junctions[j].cycleStart + junctions[j].cycle, j});
+    }
+    for (int h = 0; h < (int)heads.size(); h++) events.push({heads[h].nextSwitch, (int)junctions.size() + h});
+}
+
+void SignalController::update(double dt, std::vector<Road>& roads, const std::vector<Car>& cars,
+                              const LaneIndex& index) {
+    time += dt;
+    const int junctionCount = (int)junctions.size();
+    while (!events.empty() && events.top().first <= time) {
+        std::pair<double, int> e = events.top();
+        events.pop();
+        if (e.second < junctionCount) {
+            // Début de cycle d'un carrefour adaptatif : nouveaux verts, feux réévalués
+            SignalJunction& junction = junctions[e.second];
+            if (junction.cycleStart + junction.cycle != e.first) continue;
+            junction.cycleStart = e.first;
+            planJunction(e.second, roads, cars, &index);
+            for (int h : junction.heads) evaluate(h, roads);
+            events.push({junction.cycleStart + junction.cycle, e.second});
+        } else {
+            int h = e.second - junctionCount;
+            if (heads[h].nextSwitch != e.first) continue;
+            evaluate(h, roads);
+        }
+    }
+}
+
+void SignalController::writeRemaining(std::vector<Road>& roads) const {
+    for (const SignalHead& head : heads) roads[head.road].light.timer = (float)(head.nextSwitch - time);
+}
+
+bool SignalController::restore(double savedTime, const std::vector<SignalHead>& savedHeads,
+                               const std::vector<double>& cycleStarts) {
+    if (savedHeads.size() != heads.size() || cycleStarts.size() != junctions.size()) return false;
+    time = savedTime;
+    for (size_t h = 0; h < heads.size(); h++) {
+        heads[h].greenStart = savedHeads[h].greenStart;
+        heads[h].greenTime = savedHeads[h].greenTime;
+        heads[h].queue = savedHeads[h].queue;
+        heads[h].nextSwitch = savedHeads[h].nextSwitch;
+    }
+    for (size_t j = 0; j < junctions.size(); j++) junctions[j].cycleStart = cycleStarts[j];
+    rebuildQueue();
+    return true;
+}
+
+void ApplyGreenWave(std::vector<Road>& roads, const std::vector<int>& corridor, float speed) {
+    if (corridor.empty() || speed <= 0.0f) return;
+    const float cycle = roads[corridor[0]].signal.cycle;
+
+    // Début du vert de chaque feu : celui du précédent + trajet d'une ligne d'arrêt à
+    // la suivante (la longueur de la route)
+    double greenStart = 0.0;
+    for (size_t k = 0; k < corridor.size(); k++) {
+        Road& road = roads[corridor[k]];
+        if (k > 0) greenStart += road.getLength() / speed;
+        SignalPlan& plan = road.signal;
+        plan.cycle = std::max(cycle, plan.green + plan.yellow);
+
+        // Phase à t = 0
+        float rel = (float)Wrap(-greenStart, plan.cycle);
+        if (rel < plan.green) road.light = {road.end, LIGHT_GREEN, plan.green - rel};
+        else if (rel < plan.green + plan.yellow) road.light = {road.end, LIGHT_YELLOW, plan.green + plan.yellow - rel};
+        else road.light = {road.end, LIGHT_RED, plan.cycle - rel};
+    }
+}
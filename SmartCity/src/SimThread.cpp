@@ -0,0 +1,140 @@
+#include "../include/SimThread.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Attente maximale entre deux tours de boucle (réactivité aux commandes et à l'arrêt)
+const double SIM_MAX_WAIT = 0.01;
+
+double SimWallClock() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void CarWorldPose(const Car& car, const std::vector<Road>& roads, Vec2& pos, float& angle) {
+    if (car.state != DRIVING) {
+        pos = car.worldPos;
+        angle = car.rotation;
+        return;
+    }
+    const Road& r = roads[car.roadIndex];
+    Vec2 dir = r.getDir();
+    Vec2 normal = { -dir.y, dir.x };
+    pos = Vec2Add(Vec2Add(r.start, Vec2Scale(dir, car.distance)), Vec2Scale(normal, car.laneOffset));
+    angle = std::atan2(dir.y, dir.x) * (180.0f / 3.14159265358979f);
+}
+
+SimulationThread::SimulationThread(std::vector<Car>& cars, std::vector<Road>& roads,
+                                   std::vector<ParkingLot>& parkings, TrafficState& state)
+    : cars(cars), roads(roads), parkings(parkings), state(state) {}
+
+void SimulationThread::start() {
+    if (running()) return;
+    stopping = false;
+    // Premier instantané publié tout de suite : le rendu a un monde dès la première trame
+    publish(SimWallClock());
+    worker = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop() {
+    if (!running()) return;
+    stopping = true;
+    worker.join();
+    runPosted();
+}
+
+void SimulationThread::post(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(postMutex);
+    posted.push_back(std::move(fn));
+}
+
+void SimulationThread::runPosted() {
+    {
+        std::lock_guard<std::mutex> lock(postMutex);
+        executing.swap(posted);
+    }
+    if (executing.empty()) return;
+    TRACE_SCOPE("commandes");
+    for (auto& fn : executing) fn();
+    executing.clear();
+    // Le monde a pu être modifié ou remplacé (point de reprise) : le tick suivant le
+    // rapproche des voitures endormies, et pas d'interpolation avec l'avant
+    NoteFleetEdit(state);
+    dirty = true;
+    previousValid = false;
+}
+
+void SimulationThread::run() {
+    TRACE_THREAD("simulation");
+    double last = SimWallClock();
+    while (!stopping.load(std::memory_order_relaxed)) {
+        runPosted();
+
+        // Pas fixes dus depuis le dernier tour (temps mural x échelle de temps)
+        float scale = timeScale();
+        double now = SimWallClock();
+        double elapsed = now - last;
+        last = now;
+        if (StepSimulation(cars, roads, parkings, (float)(elapsed * scale), state) > 0) dirty = true;
+
+        // Une seule copie par instantané lu : tant que le rendu n'a pas pris le précédent,
+        // on ne publie pas (à x1000 les pas vont bien plus vite que l'affichage)
+        if (dirty && !snapshots.pending()) publish(now);
+
+        // Attente du prochain pas dû
+        double wait = SIM_MAX_WAIT;
+        if (scale > 0.0f)
+            wait = std::min(wait, (state.clock.fixedDt - state.clock.accumulator) / scale);
+        if (wait > 0.0) {
+            TRACE_SCOPE("attente du pas");
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+}
+
+void SimulationThread::publish(double now) {
+    ProfileScope scope(PROF_PUBLISH);
+    WorldSnapshot& s = snapshots.back();
+    const size_t n = cars.size();
+
+    // Index des voies à jour pour le culling (le prochain tick n'aura plus rien à faire)
+    SyncLaneIndex(cars, roads, state);
+
+    // Durée murale depuis la publication précédente, bornée par le temps simulé entre les
+    // deux à l'échelle courante (une pause entre les deux n'étire pas l'interpolation)
+    const bool withPrevious = previousValid && lastPos.size() == n;
+    const float scale = timeScale();
+    double interval = now - lastPublishedAt;
+    if (scale > 0.0f) interval = std::min(interval, (state.clock.time - lastPublishedTime) / scale);
+    s.tick = state.clock.tick;
+    s.time = state.clock.time;
+    s.publishedAt = now;
+    s.tickInterval = withPrevious ? interval : 0.0;
+    s.cars = cars;
+    s.roads = roads;
+    s.parkings = parkings;
+    s.index = state.index;
+    s.registryValid = state.registryCars == (int)n;
+    s.parkingStats = state.parkingStats;
+
+    // Poses de la publication précédente (quel que soit le nombre de pas depuis), puis
+    // celles de cette publication, gardées pour la suivante (échange : pas de copie)
+    s.prevPos.swap(lastPos);
+    s.prevAngle.swap(lastAngle);
+    if (!withPrevious) {
+        s.prevPos.clear();
+        s.prevAngle.clear();
+    }
+    lastPos.resize(n);
+    lastAngle.resize(n);
+    for (size_t i = 0; i < n; i++) CarWorldPose(cars[i], roads, lastPos[i], lastAngle[i]);
+    lastPublishedAt = now;
+    lastPublishedTime = state.clock.time;
+    previousValid = true;
+
+    snapshots.publish();
+    published.fetch_add(1, std::memory_order_relaxed);
+    dirty = false;
+}
@@ -1,418 +1,746 @@
-#include "../include/Simulation.hpp"
-#include "../include/ParkingLogic.hpp"
-#include <cmath>
-#include <limits>
-#include <algorithm>
-
-// Met à jour le cycle des feux tricolores (vert - jaune - rouge)
-void TrafficLight::update(float dt) {
-    timer -= dt;
-    if (timer <= 0) {
-        if (state == LIGHT_GREEN) {
-            state = LIGHT_YELLOW;
-            timer = 2.0f;
-        } else if (state == LIGHT_YELLOW) {
-            state = LIGHT_RED;
-            timer = 5.0f;
-        } else if (state == LIGHT_RED) {
-            state = LIGHT_GREEN;
-            timer = 5.0f;
-        }
-    }
-}
-
-// Vérifie si la voie est libre pour un changement de voie
-bool IsLaneFree(const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myId) {
-    for (const auto& other : cars) {
-        if (other.id == myId) continue; // ne pas se comparer à soi-même
-        if (other.roadIndex != roadIdx) continue;
-        if (other.state != DRIVING) continue;
-        if (other.currentLane == laneToCheck || other.targetLane == laneToCheck) {
-            if (std::abs(other.distance - myDist) < SAFE_DISTANCE * 1.5f) return false;
-        }
-    }
-    return true;
-}
-
-// Force la sortie de 2 voitures dans chaque parking plein pour libérer des places
-void ForceExitFromFullParkings(std::vector<Car>& cars, std::vector<ParkingLot>& parkings) {
-    for (int pidx = 0; pidx < (int)parkings.size(); pidx++) {
-        ParkingLot& p = parkings[pidx];
-
-        // Vérifier si toutes les places sont occupées
-        bool isFull = true;
-        for (bool occupied : p.spotsOccupied) {
-            if (!occupied) {
-                isFull = false;
-                break;
-            }
-        }
-    }
-}
-
-// Mise à jour principale de la simulation
-void UpdateTraffic(std::vector<Car>& cars, std::vector<Road>& roads,
-                   std::vector<ParkingLot>& parkings, float dt) {
-    // Gestion des sorties forcées si parkings pleins
-    ForceExitFromFullParkings(cars, parkings);
-
-    // Mise à jour des feux sur chaque route
-    for (auto& road : roads) road.light.update(dt);
-
-    // Trier les voitures de l'avant vers l'arrière pour logique cohérente de déplacement
-    std::sort(cars.begin(), cars.end(), [](const Car& a, const Car& b) {
-        if (a.roadIndex == b.roadIndex)
-            return a.distance > b.distance;
-        return a.roadIndex < b.roadIndex;
-    });
-
-    for (auto& car : cars) {
-        if (car.state == DRIVING) {
-            if (car.waitTimer > 0) car.waitTimer -= dt; // UPDATE: Decrement timer in DRIVING
-
-            Road& road = roads[car.roadIndex];
-            float roadLength = road.getLength();
-
-            Vector2 dir = road.getDir();
-            Vector2 normal = { -dir.y, dir.x };
-            Vector2 centerPos = Vector2Add(road.start, Vector2Scale(dir, car.distance));
-            car.worldPos = Vector2Add(centerPos, Vector2Scale(normal, car.laneOffset));
-
-            // Décision aléatoire d'aller se garer dans un parking disponible
-            // UPDATE: Check timer to prevent immediate re-parking
-            if (car.parkingIdx == -1 && car.waitTimer <= 0) {
-                if (car.distance > 50 && GetRandomValue(0, 500) < 2) {
-                    int bestIdx = -1;
-                    float minDist = std::numeric_limits<float>::max();
-
-                    // Restauration: On ne cherche que les parkings du même coté de la voie
-                    int startIdx = 0; 
-                    int endIdx = 0;
-                    
-                    if (car.roadIndex == 0) { // Road 1 (Top)
-                        // Ln 0 (Top side) -> P0 (VIP)
-                        // Ln 1 (Bottom side) -> P1 (Central Median)
-                        if (car.currentLane == 0) { startIdx = 0; endIdx = 1; }
-                        else { startIdx = 1; endIdx = 2; }
-                    } else { // Road 2 (Bottom)
-                        // Ln 0 (Bottom side) -> P2, P3
-                        // Ln 1 (Top side) -> Rien (ou P1 aussi ? Non restons simple)
-                        if (car.currentLane == 0) { startIdx = 2; endIdx = 4; }
-                        else { startIdx = 0; endIdx = 0; }
-                    }
-                    
-                    for (int i = startIdx; i < endIdx && i < (int)parkings.size(); i++) {
-                        // ... (same loop) ...
-                        if (parkings[i].firstFreeSpot() != -1) { 
-                            float dist = Vector2Distance(car.worldPos, parkings[i].position);
-                            if (dist < minDist) {
-                                minDist = dist;
-                                bestIdx = i;
-                            }
-                        }
-                    }
-                    if (bestIdx != -1) {
-                         // Restriction VIP (Index 0) : Max 2 voitures
-                         if (bestIdx == 0) {
-                             int vipCount = 0;
-                             for (const auto& other : cars) {
-                                 if (other.parkingIdx == 0) vipCount++;
-                             }
-                             if (vipCount >= 1) {
-                                 bestIdx = -1; // Trop cher/plein pour ce pauvre conducteur
-                             }
-                         }
-                         if (bestIdx != -1) car.parkingIdx = bestIdx;
-                    }
-                }
-            }
-
-
-            // Approche parking selon la voie autorisée sur chaque parking
-            if (car.parkingIdx != -1) {
-                ParkingLot& p = parkings[car.parkingIdx];
-                float entranceX = p.position.x + p.size.x / 2;
-
-                bool correctLane = false;
-                if (car.parkingIdx == 0)      correctLane = (car.currentLane == 0); // VIP -> Ln 0
-                else if (car.parkingIdx == 1) correctLane = (car.currentLane == 1); // Central -> Ln 1
-                else                          correctLane = (car.currentLane == 0); // Eco/City -> Ln 0 (sur R2)
-
-                if (correctLane) {
-                    if (std::abs(car.worldPos.x - entranceX) < 10.0f) {
-                        int spot = p.firstFreeSpot();
-                        if (spot != -1) {
-                            car.state = TO_PARKING;
-                            car.spotIdx = spot;
-                            car.targetPos = GetSpotPosition(p, spot);
-                            p.occupySpot(spot);
-                        } else {
-                            car.parkingIdx = -1;
-                        }
-                    }
-                } else {
-                    car.parkingIdx = -1; // Mauvaise voie, on annule
-                }
-            }
-
-            // Détection obstacle devant pour la voiture sur la route et freinage/ralentissement adapté
-            float distToObstacle = std::numeric_limits<float>::max();
-            for (const auto& other : cars) {
-                if (car.id == other.id) continue;
-
-                // On ignore les voitures garées
-                if (other.state == PARKED) continue;
-                
-                
-                
-                if (car.roadIndex == other.roadIndex && car.currentLane == other.currentLane) {
-                    // Si other est LEAVING, sa distance n'est pas encore sur la route... 
-                    // Sauf si on considère sa position projetée ?
-                    // Le plus critique est TO_PARKING qui disparait subitement.
-                    
-                    if (other.state == DRIVING || other.state == TO_PARKING) {
-                         if (other.distance > car.distance) {
-                            float d = other.distance - car.distance;
-                            if (d < distToObstacle)
-                                distToObstacle = d;
-                        }
-                    }
-                    else if (other.state == LEAVING_PARKING) {
-                         // Pour une voiture qui sort, sa position sur la route est approximée par sa cible (le point de sortie)
-                         // On projette targetPos sur la route
-                         Road& r = roads[other.roadIndex];
-                         Vector2 dir = r.getDir();
-                         Vector2 v = Vector2Subtract(other.targetPos, r.start);
-                         float otherDist = v.x * dir.x + v.y * dir.y;
-
-                         if (otherDist > car.distance) {
-                             float d = otherDist - car.distance;
-                             if (d < distToObstacle)
-                                 distToObstacle = d;
-                         }
-                    }
-                }
-            }
-
-            // Impact du feu sur la vitesse
-            if (road.light.state != LIGHT_GREEN) {
-                float distToLight = (roadLength - 200.0f) - car.distance;
-                if (distToLight > 0 && distToLight < distToObstacle)
-                    distToObstacle = distToLight;
-            }
-
-            // Calcul et application de la vitesse cible
-            float targetSpeed = MAX_SPEED;
-            // La voiture fait 40px de long. Distance centre à centre min = 40.
-            // On freine d'urgence si on est trop près (< 45px pour laisser 5px de marge)
-            if (distToObstacle < 45.0f) {
-                car.speed = 0.0f; // freinage d'urgence
-            } else if (distToObstacle < SAFE_DISTANCE) {
-                targetSpeed = 0.0f;
-                car.speed = Lerp(car.speed, targetSpeed, 10.0f * dt);
-            } else if (distToObstacle < SAFE_DISTANCE * 2.5f) {
-                targetSpeed = MAX_SPEED * 0.3f;
-                car.speed = Lerp(car.speed, targetSpeed, 5.0f * dt);
-            } else {
-                car.speed = Lerp(car.speed, MAX_SPEED, 5.0f * dt);
-            }
-            if (car.parkingIdx != -1)
-                car.speed = std::min(car.speed, 80.0f);
-
-            car.distance += car.speed * dt;
-
-            if (car.distance > roadLength + 50) {
-                car.distance = -CAR_LENGTH;
-                car.speed = MAX_SPEED;
-                car.parkingIdx = -1;
-                car.roadIndex = 1 - car.roadIndex; // Switch to the other road (Loop)
-            }
-        }
-        else if (car.state == TO_PARKING) {
-            // Détection obstacle pour freinage progressif
-            float distToObstacle = std::numeric_limits<float>::max();
-            
-            for (const auto& other : cars) {
-                if (other.id == car.id) continue;
-                
-                // 1. Obstacle DANS le parking (qui entre ou sort)
-                if ((other.state == TO_PARKING || other.state == LEAVING_PARKING) && other.parkingIdx == car.parkingIdx) {
-                    float dist = Vector2Distance(car.worldPos, other.worldPos);
-                    // Vision Cone (~45 deg)
-                    Vector2 myDir = Vector2Subtract(car.targetPos, car.worldPos);
-                    Vector2 toOther = Vector2Subtract(other.worldPos, car.worldPos);
-                    
-                    if (Vector2DotProduct(Vector2Normalize(myDir), Vector2Normalize(toOther)) > 0.7f) {
-                         if (dist < distToObstacle) distToObstacle = dist;
-                    }
-                }
-                
-                // 2. Obstacle SUR LA ROUTE (embouteillage entrée)
-                if (other.state == DRIVING && other.roadIndex == car.roadIndex && other.currentLane == car.currentLane) {
-                     float d = other.distance - car.distance;
-                     if (d > 0 && d < 60.0f) {
-                         // On convertit cette distance road-based en distance physique approx
-                         if (d < distToObstacle) distToObstacle = d;
-                     }
-                }
-            }
-
-            // Calcul vitesse progressive
-            float targetSpeed = 80.0f; // Vitesse max parking
-            if (distToObstacle < 45.0f) {
-                targetSpeed = 0.0f; // Arrêt complet
-            } else if (distToObstacle < 100.0f) {
-                // Freinage linéaire entre 100px et 45px
-                float factor = (distToObstacle - 45.0f) / (100.0f - 45.0f);
-                targetSpeed = 80.0f * factor;
-            }
-
-            // Lissage de la vitesse
-            car.speed = Lerp(car.speed, targetSpeed, 10.0f * dt);
-            
-            // Application du mouvement (si on roule)
-            if (car.speed > 0.1f) {
-                // Mouvement "Manhattan" : On s'aligne en X d'abord, puis on entre en Y.
-                float dx = car.targetPos.x - car.worldPos.x;
-                float dy = car.targetPos.y - car.worldPos.y;
-                float step = car.speed * dt;
-
-                // Phase 1 : Alignement horizontal (Allée)
-                if (std::abs(dx) > 2.0f) {
-                    car.worldPos.x += (dx > 0 ? step : -step);
-                    car.rotation = (dx > 0) ? 0.0f : 180.0f;
-                } 
-                // Phase 2 : Entrée dans la place (Vertical)
-                else {
-                    car.worldPos.x = car.targetPos.x; 
-                    if (std::abs(dy) > 2.0f) {
-                        car.worldPos.y += (dy > 0 ? step : -step);
-                        car.rotation = (dy > 0) ? 90.0f : 270.0f;
-                    } else {
-                        // Arrivé
-                        car.state = PARKED;
-                        car.waitTimer = GetRandomValue(15, 25);
-                        car.worldPos = car.targetPos;
-                        car.speed = 0;
-                    }
-                }
-            }
-        }
-
-
-       else if (car.state == PARKED) {
-            car.waitTimer -= dt;
-            if (car.waitTimer <= 0) {
-                // 1. Définir la cible de sortie (exitPos)
-                car.targetPos = parkings[car.parkingIdx].exitPos; 
-
-                // --- SECURITE : Vérifier si la voie est libre avant de sortir ---
-                // On projette la position de sortie sur la route pour estimer la distance
-                Road& road = roads[car.roadIndex];
-                Vector2 roadDir = road.getDir();
-                Vector2 exitVec = Vector2Subtract(car.targetPos, road.start);
-                float projectedDist = (exitVec.x * roadDir.x + exitVec.y * roadDir.y);
-                
-                // On vérifie la voie de droite 
-                // P0 (Top/Left) -> Lane 0
-                // P1 (Median/Right) -> Lane 1
-                // P2, P3 (Bottom/Left of R2) -> Lane 0
-                int exitLane = (car.parkingIdx == 1) ? 1 : 0;
-
-                // Check 1: Est-ce que quelqu'un d'autre est DÉJÀ en train de sortir de ce parking ?
-                bool someoneExiting = false;
-                for(const auto& other : cars) {
-                     if (other.id != car.id && other.parkingIdx == car.parkingIdx && other.state == LEAVING_PARKING) {
-                         someoneExiting = true;
-                         break;
-                     }
-                }
-
-                // Check 2: Est-ce que la route est "vide" (grand espace libre) ?
-                bool isRoadClear = true;
-                if (!someoneExiting) {
-                    for (const auto& other : cars) {
-                        if (other.id == car.id) continue;
-                        
-                        // On vérifie DRIVING et TO_PARKING sur TOUTE LA ROUTE (toutes les voies)
-                        // Si la route est "pleine" (même sur l'autre voie), on attend.
-                        if (other.roadIndex == car.roadIndex && 
-                           (other.state == DRIVING || other.state == TO_PARKING)) {
-                            
-                            float diff = projectedDist - other.distance;
-                            
-                            // Voitures arrivant de derrière (Upstream)
-                            // On utilise délibérément une marge LARGE basée sur SAFE_DISTANCE
-                            if (diff > 0 && diff < SAFE_DISTANCE * 6.0f) { 
-                                isRoadClear = false; 
-                                break;
-                            }
-                            
-                            // Voitures juste devant (Downstream)
-                            if (diff < 0 && diff > -SAFE_DISTANCE * 3.0f) { 
-                                isRoadClear = false; 
-                                break;
-                            }
-                        }
-                    }
-                }
-
-                if (!someoneExiting && isRoadClear) {
-                    car.state = LEAVING_PARKING;
-                } else {
-                    // Si pas libre, on attend encore un peu
-                    car.waitTimer = 1.0f; 
-                }
-            }
-        }
-  else if (car.state == LEAVING_PARKING) {
-    float roadY = (car.roadIndex == 0) ? 250.0f : 600.0f;
-    float dy = roadY - car.worldPos.y;
-    float moveSpeed = 80.0f * dt;
-
-    // PHASE 1: sortis vertical
-    if (std::abs(dy) > 2.0f) {
-        
-        
-        car.rotation = (dy < 0) ? 270.0f : 90.0f; 
-        car.worldPos.y += (dy > 0 ? moveSpeed : -moveSpeed);
-        continue; // CORRECTIF : continue au lieu de return pour ne pas bloquer les autres voitures
-    }
-
-    // PHASE 2: rotation pour se mettre dans la route
-    
-    if (std::abs(car.rotation) > 2.0f && std::abs(car.rotation) < 358.0f) {
-        float rotSpeed = 400.0f * dt;
-        
-    //horizontalement dans la route
-        if (car.rotation > 180.0f) car.rotation += rotSpeed; 
-        else car.rotation -= rotSpeed; 
-        // N-hadiw l-angle bach ma-i-foutch 360
-        if (car.rotation >= 360.0f) car.rotation = 0.0f;
-        if (car.rotation < 0.0f) car.rotation = 0.0f;
-        
-        continue; // CORRECTIF : continue au lieu de return
-    }
-
-    // PHASE 3: REPRENDRE LA ROUTE (Driving)
-    car.worldPos.y = roadY;
-    car.rotation = 0.0f; // Fixation finale
-    car.state = DRIVING;
-
-    Road& road = roads[car.roadIndex];
-    Vector2 roadDir = road.getDir();
-    Vector2 carVec = Vector2Subtract(car.worldPos, road.start);
-    car.distance = (carVec.x * roadDir.x + carVec.y * roadDir.y);
-
-    if (car.parkingIdx != -1) {
-        parkings[car.parkingIdx].freeSpot(car.spotIdx);
-    }
-    
-    car.parkingIdx = -1;
-    car.speed = 50.0f;
-    // UPDATE: Ajouter un cooldown pour ne pas rentrer directement dans le parking
-    car.waitTimer = 10.0f; 
-}
-}
-    }
-
+#include "../include/Simulation.hpp"
+#include "../include/ParkingLogic.hpp"
+#include "../include/Random.hpp"
+#include "../include/Recorder.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/Trace.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// Vérifie si la voie est libre pour un changement de voie
+bool IsLaneFree(const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myId) {
+    for (const auto& other : cars) {
+        if (other.id == myId) continue; // ne pas se comparer à soi-même
+        if (other.roadIndex != roadIdx) continue;
+        if (other.state != DRIVING) continue;
+        if (other.currentLane == laneToCheck || other.targetLane == laneToCheck) {
+            if (std::abs(other.distance - myDist) < SAFE_DISTANCE * 1.5f) return false;
+        }
+    }
+    return true;
+}
+
+// Même vérification via l'index de voies : seules les voitures proches sont examinées
+bool IsLaneFree(const LaneIndex& index, const std::vector<Car>& cars, int roadIdx, int laneToCheck, float myDist, int myIdx) {
+    const float range = SAFE_DISTANCE * 1.5f;
+    for (int lane = 0; lane < index.laneCount(); lane++) {
+        bool blocked = false;
+        index.forEachInRange(roadIdx, lane, myDist - range, myDist + range, [&](int j, float) {
+            const Car& other = cars[j];
+            if (j == myIdx || other.state != DRIVING) return true;
+            if (other.currentLane == laneToCheck || other.targetLane == laneToCheck) {
+                blocked = true;
+                return false;
+            }
+            return true;
+        });
+        if (blocked) return false;
+    }
+    return true;
+}
+
+// ---------------------------
+//  Phase 1 : perception (lecture seule de l'état du tick précédent)
+// ---------------------------
+static CarPerception SenseCar(int i, const std::vector<Car>& cars, const std::vector<ParkingLot>& parkings, const TrafficState& state, float dt) {
+    const Car& car = cars[i];
+    const LaneIndex& index = state.index;
+    CarPerception out = { std::numeric_limits<float>::max(), false };
+
+    if (car.state == DRIVING) {
+        // Détection obstacle devant pour la voiture sur la route
+        // Leader DRIVING/TO_PARKING sur la même voie (les voitures garées ne sont pas indexées)
+        int leader = index.leaderOf(i);
+        if (leader != -1) {
+            out.distToObstacle = cars[leader].distance - car.distance;
+        } else {
+            // Dernière de sa voie : file au début de la route suivante, si elle est connue
+            // d'avance (sans tirage) et contiguë. Après un carrefour à plusieurs sorties, la
+            // route n'est tirée qu'au passage : rien n'est vu au-delà de la fin de la route.
+            const RoadNetwork& network = state.network;
+            int nextRoad = network.forcedSuccessor(car.roadIndex);
+            if (nextRoad >= 0 && nextRoad != car.roadIndex && network.continuous(car.roadIndex, nextRoad)) {
+                int lane = std::min(car.currentLane, network.segment(nextRoad).lanes - 1);
+                int ahead = index.leader(nextRoad, lane, -std::numeric_limits<float>::max());
+                if (ahead != -1)
+                    out.distToObstacle = network.segment(car.roadIndex).length - car.distance + cars[ahead].distance;
+            }
+        }
+
+        // Pour une voiture qui sort, sa position sur la route est approximée par sa cible
+        // (le point de sortie projeté sur la route)
+        float exitDist = index.nearestLeavingAhead(car.roadIndex, car.currentLane, car.distance);
+        if (exitDist - car.distance < out.distToObstacle)
+            out.distToObstacle = exitDist - car.distance;
+    }
+    else if (car.state == TO_PARKING) {
+        // Obstacle DANS le parking (qui entre ou sort) : seules les voitures de ce parking
+        if (car.parkingIdx >= 0 && car.parkingIdx < (int)parkings.size()) {
+            const ParkingLot& lot = parkings[car.parkingIdx];
+            for (const std::vector<int>* list : {&lot.entering, &lot.leaving}) {
+                for (int j : *list) {
+                    if (j == i) continue;
+                    const Car& other = cars[j];
+                    if (other.state != TO_PARKING && other.state != LEAVING_PARKING) continue; // en approche sur la route
+
+                    float dist = Vec2Distance(car.worldPos, other.worldPos);
+                    // Vision Cone (~45 deg)
+                    Vec2 myDir = Vec2Subtract(car.targetPos, car.worldPos);
+                    Vec2 toOther = Vec2Subtract(other.worldPos, car.worldPos);
+
+                    if (Vec2DotProduct(Vec2Normalize(myDir), Vec2Normalize(toOther)) > 0.7f) {
+                         if (dist < out.distToObstacle) out.distToObstacle = dist;
+                    }
+                }
+            }
+        }
+
+        // Obstacle SUR LA ROUTE (embouteillage entrée) : première voiture DRIVING devant à moins de 60px
+        index.forEachInRange(car.roadIndex, car.currentLane, car.distance, car.distance + 60.0f,
+                             [&](int j, float otherDist) {
+            if (cars[j].state != DRIVING) return true;
+            // On convertit cette distance road-based en distance physique approx
+            float d = otherDist - car.distance;
+            if (d < out.distToObstacle) out.distToObstacle = d;
+            return false;
+        });
+    }
+    else if (car.state == PARKED && car.waitTimer - dt <= 0) {
+        // --- SECURITE : Vérifier si la voie est libre avant de sortir ---
+        // On projette la position de sortie sur la route pour estimer la distance
+        float projectedDist = state.network.segment(car.roadIndex).project(parkings[car.parkingIdx].exitPos);
+
+        // On vérifie DRIVING et TO_PARKING sur TOUTE LA ROUTE (toutes les voies)
+        // Si la route est "pleine" (même sur l'autre voie), on attend.
+        out.roadClear = true;
+        for (int lane = 0; lane < index.laneCount() && out.roadClear; lane++) {
+            // Voitures arrivant de derrière (Upstream) : marge délibérément LARGE (6 x SAFE_DISTANCE)
+            // Voitures juste devant (Downstream) : 3 x SAFE_DISTANCE
+            // Une voiture arrêtée pile au point de sortie bloque aussi la sortie.
+            if (index.anyInRange(car.roadIndex, lane, projectedDist - SAFE_DISTANCE * 6.0f,
+                                 projectedDist + SAFE_DISTANCE * 3.0f, i))
+                out.roadClear = false;
+        }
+    }
+    return out;
+}
+
+// ---------------------------
+//  Phase 2 : décision / action, par voiture, dans le tampon arrière
+//  (n'écrit que next[i], kin[i] et intents[i])
+// ---------------------------
+static unsigned char DecideDriving(Car& car, int i, int32_t parkRoll, const std::vector<Road>& roads,
+                                   const std::vector<ParkingLot>& parkings, TrafficState& state, float dt) {
+    unsigned char intent = INTENT_NONE;
+    if (car.waitTimer > 0) car.waitTimer -= dt; // UPDATE: Decrement timer in DRIVING
+
+    const Road& road = roads[car.roadIndex];
+    const RoadNetwork& network = state.network;
+    const RoadSegment& seg = network.segment(car.roadIndex);
+    float roadLength = seg.length;
+
+    car.worldPos = seg.pointAt(car.distance, car.laneOffset);
+
+    // Réservation expirée (approche trop longue) : la place est rendue à l'application
+    if (car.parkingIdx != -1 && car.spotIdx != -1 && car.waitTimer <= 0) {
+        car.parkingIdx = -1;
+        car.spotIdx = -1;
+        intent |= INTENT_EXPIRED;
+    }
+
+    // Décision aléatoire d'aller se garer dans un parking disponible
+    // UPDATE: Check timer to prevent immediate re-parking
+    if (car.parkingIdx == -1 && car.waitTimer <= 0) {
+        if (car.distance > 50 && parkRoll < 2) {
+            // Parking disponible le moins coûteux (distance + prix) parmi ceux que dessert la voie,
+            // entrée devant la voiture
+            int bestIdx = state.lots.cheapest(car.roadIndex, car.currentLane, car.worldPos, state.priceWeight,
+                                              car.distance);
+            if (bestIdx == -1) intent |= INTENT_NO_LOT;
+            if (bestIdx != -1) {
+                 // Restriction VIP (Index 0) : une seule voiture engagée à la fois
+                 // (revérifié à l'application si plusieurs voitures choisissent ce tick)
+                 if (bestIdx == 0 && parkings[0].committedCount() >= 1) {
+                     bestIdx = -1; // Trop cher/plein pour ce pauvre conducteur
+                 }
+                 if (bestIdx != -1) {
+                     car.parkingIdx = bestIdx;
+                     intent |= INTENT_CHOOSE_LOT;
+                 }
+            }
+        }
+    }
+
+    // Approche parking selon la voie autorisée sur chaque parking
+    if (car.parkingIdx != -1) {
+        bool correctLane = car.roadIndex == network.lotRoad(car.parkingIdx) &&
+                           car.currentLane == network.lotLane(car.parkingIdx);
+
+        float fromEntrance = car.distance - network.lotEntrance(car.parkingIdx);
+        if (correctLane && fromEntrance < LOT_ENTRY_WINDOW) {
+            // Arrivé à l'entrée : la place est attribuée à l'application des actions
+            if (std::abs(fromEntrance) < LOT_ENTRY_WINDOW)
+                intent |= INTENT_CLAIM_SPOT;
+        } else {
+            car.parkingIdx = -1; // Mauvaise voie ou entrée dépassée, on annule
+            car.spotIdx = -1;
+            intent &= ~INTENT_CHOOSE_LOT;
+        }
+    }
+
+    float distToObstacle = state.perception[i].distToObstacle;
+
+    // Impact du feu sur la vitesse
+    if (road.light.state != LIGHT_GREEN) {
+        float distToLight = (roadLength - SIGNAL_STOP_OFFSET) - car.distance;
+        if (distToLight > 0 && distToLight < distToObstacle)
+            distToObstacle = distToLight;
+    }
+
+    // Calcul de la vitesse cible (appliquée ensuite par IntegrateKinematics)
+    // La voiture fait 40px de long. Distance centre à centre min = 40.
+    // On freine d'urgence si on est trop près (< 45px pour laisser 5px de marge)
+    CarStore& kin = state.kin;
+    if (distToObstacle < 45.0f) {
+        kin.targetSpeed[i] = 0.0f; // freinage d'urgence
+        kin.blend[i] = 1.0f;
+    } else if (distToObstacle < SAFE_DISTANCE) {
+        kin.targetSpeed[i] = 0.0f;
+        kin.blend[i] = 10.0f * dt;
+    } else if (distToObstacle < SAFE_DISTANCE * 2.5f) {
+        kin.targetSpeed[i] = MAX_SPEED * 0.3f;
+        kin.blend[i] = 5.0f * dt;
+    } else {
+        kin.targetSpeed[i] = MAX_SPEED;
+        kin.blend[i] = 5.0f * dt;
+    }
+    if (car.parkingIdx != -1)
+        kin.speedCap[i] = 80.0f;
+
+    return intent;
+}
+
+static void DecideToParking(Car& car, int i, int32_t dwell, const TrafficState& state, float dt) {
+    // Calcul vitesse progressive
+    float distToObstacle = state.perception[i].distToObstacle;
+    float targetSpeed = 80.0f; // Vitesse max parking
+    if (distToObstacle < 45.0f) {
+        targetSpeed = 0.0f; // Arrêt complet
+    } else if (distToObstacle < 100.0f) {
+        // Freinage linéaire entre 100px et 45px
+        float factor = (distToObstacle - 45.0f) / (100.0f - 45.0f);
+        targetSpeed = 80.0f * factor;
+    }
+
+    // Lissage de la vitesse
+    car.speed = LerpF(car.speed, targetSpeed, 10.0f * dt);
+    
+    // Application du mouvement (si on roule)
+    if (car.speed > 0.1f) {
+        // Mouvement "Manhattan" : On s'aligne en X d'abord, puis on entre en Y.
+        float dx = car.targetPos.x - car.worldPos.x;
+        float dy = car.targetPos.y - car.worldPos.y;
+        float step = car.speed * dt;
+
+        // Phase 1 : Alignement horizontal (Allée)
+        if (std::abs(dx) > 2.0f) {
+            car.worldPos.x += (dx > 0 ? step : -step);
+            car.rotation = (dx > 0) ? 0.0f : 180.0f;
+        } 
+        // Phase 2 : Entrée dans la place (Vertical)
+        else {
+            car.worldPos.x = car.targetPos.x; 
+            if (std::abs(dy) > 2.0f) {
+                car.worldPos.y += (dy > 0 ? step : -step);
+                car.rotation = (dy > 0) ? 90.0f : 270.0f;
+            } else {
+                // Arrivé
+                car.state = PARKED;
+                car.waitTimer = (float)dwell;
+                car.worldPos = car.targetPos;
+                car.speed = 0;
+            }
+        }
+    }
+}
+
+static unsigned char DecideParked(Car& car, int i, const std::vector<ParkingLot>& parkings,
+                                  const TrafficState& state, float dt) {
+    car.waitTimer -= dt;
+    if (car.waitTimer > 0) return INTENT_NONE;
+
+    // 1. Définir la cible de sortie (exitPos)
+    car.targetPos = parkings[car.parkingIdx].exitPos; 
+
+    // Check 1: Est-ce que quelqu'un d'autre est DÉJÀ en train de sortir de ce parking ?
+    bool someoneExiting = !parkings[car.parkingIdx].leaving.empty();
+
+    // Check 2: Est-ce que la route est "vide" (grand espace libre) ? (phase perception)
+    if (!someoneExiting && state.perception[i].roadClear)
+        return INTENT_EXIT;
+
+    // Si pas libre, on attend encore un peu
+    car.waitTimer = 1.0f; 
+    return INTENT_NONE;
+}
+
+static unsigned char DecideLeaving(Car& car, const TrafficState& state, float dt) {
+    const RoadSegment& seg = state.network.segment(car.roadIndex);
+    float offset = seg.sideOffset(car.worldPos); // écart à l'axe de la route
+    float moveSpeed = 80.0f * dt;
+
+    // PHASE 1: sortie perpendiculaire à la route, jusqu'à son axe
+    if (std::abs(offset) > 2.0f) {
+        Vec2 toRoad = (offset > 0) ? Vec2Scale(seg.normal, -1.0f) : seg.normal;
+        car.rotation = std::atan2(toRoad.y, toRoad.x) * 57.29578f;
+        if (car.rotation < 0.0f) car.rotation += 360.0f;
+        car.worldPos = Vec2Add(car.worldPos, Vec2Scale(toRoad, moveSpeed));
+        return INTENT_NONE;
+    }
+
+    // PHASE 2: rotation pour se mettre dans le sens de la route (par le plus court)
+    float turn = seg.heading - car.rotation;
+    while (turn > 180.0f) turn -= 360.0f;
+    while (turn <= -180.0f) turn += 360.0f;
+    if (std::abs(turn) > 2.0f) {
+        float rotSpeed = 400.0f * dt;
+        // N-hadiw l-angle bach ma-i-foutch l-cap de la route
+        if (std::abs(turn) <= rotSpeed) car.rotation = seg.heading;
+        else car.rotation += (turn > 0 ? rotSpeed : -rotSpeed);
+        if (car.rotation >= 360.0f) car.rotation -= 360.0f;
+        if (car.rotation < 0.0f) car.rotation += 360.0f;
+        return INTENT_NONE;
+    }
+
+    // PHASE 3: REPRENDRE LA ROUTE (Driving)
+    car.worldPos = Vec2Subtract(car.worldPos, Vec2Scale(seg.normal, offset));
+    car.rotation = seg.heading; // Fixation finale
+    car.state = DRIVING;
+    car.distance = seg.project(car.worldPos);
+
+    // La place est libérée à l'application des actions
+    unsigned char intent = (car.parkingIdx != -1) ? INTENT_RELEASE_SPOT : INTENT_NONE;
+    
+    car.parkingIdx = -1;
+    car.spotIdx = -1;
+    car.speed = 50.0f;
+    // UPDATE: Ajouter un cooldown pour ne pas rentrer directement dans le parking
+    car.waitTimer = 10.0f; 
+    return intent;
+}
+
+// k : rang de la voiture dans state.active (celui de ses tirages)
+static void DecideCar(int k, const std::vector<Car>& cars, const std::vector<Road>& roads,
+                      const std::vector<ParkingLot>& parkings, TrafficState& state, float dt) {
+    const int i = state.active[k];
+    Car& car = state.next[i];
+    car = cars[i];
+
+    unsigned char intent = INTENT_NONE;
+    if (car.state == DRIVING)              intent = DecideDriving(car, i, state.parkRoll[k], roads, parkings, state, dt);
+    else if (car.state == TO_PARKING)      DecideToParking(car, i, state.dwell[k], state, dt);
+    else if (car.state == PARKED)          intent = DecideParked(car, i, parkings, state, dt);
+    else if (car.state == LEAVING_PARKING) intent = DecideLeaving(car, state, dt);
+
+    // Arrivée sur la place, abandon du parking... : le registre sera mis à jour à l'application
+    if (car.state != cars[i].state || car.parkingIdx != cars[i].parkingIdx)
+        intent |= INTENT_REGISTRY;
+    state.intents[i] = intent;
+}
+
+// Reprend dans le tampon arrière la cinématique calculée par le noyau vectorisé
+// et fait passer la voiture sur la route suivante du réseau en fin de route
+static void ApplyKinematics(int i, TrafficState& state) {
+    if (state.kin.state[i] != DRIVING) return;
+    Car& car = state.next[i];
+    car.speed = state.kin.speed[i];
+    car.distance = state.kin.distance[i];
+
+    const RoadNetwork& network = state.network;
+    const RoadSegment& seg = network.segment(car.roadIndex);
+    if (car.distance <= seg.length) return;
+
+    int nextRoad = network.successor(car.roadIndex, (uint32_t)car.id, state.seed, state.tick);
+    if (network.continuous(car.roadIndex, nextRoad)) {
+        // Routes qui se touchent : la voiture continue avec son avance
+        car.distance -= seg.length;
+    } else if (car.distance > seg.length + 50) {
+        // Lien par téléportation (boucle de la ville) : réapparition hors écran
+        car.distance = -CAR_LENGTH;
+        car.speed = MAX_SPEED;
+    } else {
+        return;
+    }
+
+    if (car.parkingIdx != -1) state.intents[i] |= INTENT_REGISTRY;
+    car.parkingIdx = -1;
+    car.spotIdx = -1;
+    car.roadIndex = nextRoad;
+    const RoadSegment& next = network.segment(nextRoad);
+    car.currentLane = std::min(car.currentLane, next.lanes - 1);
+    car.targetLane = std::min(car.targetLane, next.lanes - 1);
+    car.laneOffset = next.laneOffset(car.currentLane);
+}
+
+// ---------------------------
+//  Phase 3 : application en série des actions sur les parkings partagés,
+//  dans l'ordre de la flotte (donc indépendante du nombre de threads)
+// ---------------------------
+// Distance parcourue depuis le choix du parking (jusqu'au bout de la route si la voiture en a changé)
+static float ApproachDriven(const Car& before, const Car& after, float start, const RoadNetwork& network) {
+    float end = (after.roadIndex == before.roadIndex) ? after.distance : network.segment(before.roadIndex).length;
+    return std::max(end - start, 0.0f);
+}
+
+static void CommitIntents(const std::vector<Car>& cars, std::vector<ParkingLot>& parkings, TrafficState& state) {
+    const int lotCount = (int)parkings.size();
+    ParkingSearchStats& stats = state.parkingStats;
+    for (int i : state.active) {
+        unsigned char intent = state.intents[i];
+        if (intent == INTENT_NONE) continue;
+        Car& car = state.next[i];
+        const Car& before = cars[i];
+
+        // Approche abandonnée (mauvaise voie, route suivante, entrée dépassée, expiration) :
+        // recherche échouée, distance perdue, et place rendue si elle était réservée
+        if (before.state == DRIVING && before.parkingIdx >= 0 &&
+            (car.parkingIdx != before.parkingIdx || car.spotIdx != before.spotIdx)) {
+            stats.failedSearches++;
+            stats.wastedDistance += ApproachDriven(before, car, state.approachStart[i], state.network);
+            if (before.spotIdx >= 0) {
+                parkings[before.parkingIdx].freeSpot(before.spotIdx);
+                state.lots.update(before.parkingIdx, parkings[before.parkingIdx]);
+                if (intent & INTENT_EXPIRED) stats.expired++;
+                else stats.cancelled++;
+            }
+        }
+        if (intent & INTENT_NO_LOT) stats.noLot++;
+
+        if ((intent & INTENT_CHOOSE_LOT) && car.parkingIdx != -1) {
+            stats.searches++;
+            state.approachStart[i] = car.distance;
+            // Restriction VIP : un seul engagement même si plusieurs voitures ont choisi ce tick
+            // (le registre compte déjà les voitures engagées plus tôt dans ce tick)
+            if (car.parkingIdx == 0 && parkings[0].committedCount() >= 1) {
+                car.parkingIdx = -1;
+                intent &= ~INTENT_CLAIM_SPOT;
+                stats.failedSearches++;
+            } else if (car.distance - state.network.lotEntrance(car.parkingIdx) >= LOT_ENTRY_WINDOW) {
+                // Entrée dépassée pendant le pas (choix juste devant, à grande vitesse) : rien à réserver
+                car.parkingIdx = -1;
+                intent &= ~INTENT_CLAIM_SPOT;
+                stats.failedSearches++;
+            } else if (state.reserveSpots) {
+                // Place réservée tout de suite ; le parking a pu se remplir plus tôt dans ce tick
+                ParkingLot& p = parkings[car.parkingIdx];
+                int spot = p.firstFreeSpot();
+                if (spot != -1) {
+                    p.occupySpot(spot);
+                    state.lots.update(car.parkingIdx, p);
+                    car.spotIdx = spot;
+                    car.waitTimer = RESERVATION_TTL;
+                    stats.reservations++;
+                } else {
+                    car.parkingIdx = -1;
+                    intent &= ~INTENT_CLAIM_SPOT;
+                    stats.failedSearches++;
+                }
+            }
+        }
+
+        if ((intent & INTENT_CLAIM_SPOT) && car.parkingIdx != -1) {
+            // Place réservée, sinon la première libre à l'arrivée
+            ParkingLot& p = parkings[car.parkingIdx];
+            bool reserved = car.spotIdx != -1;
+            int spot = reserved ? car.spotIdx : p.firstFreeSpot();
+            if (spot != -1) {
+                car.state = TO_PARKING;
+                car.spotIdx = spot;
+                car.targetPos = GetSpotPosition(p, spot);
+                if (!reserved) {
+                    p.occupySpot(spot);
+                    state.lots.update(car.parkingIdx, p);
+                }
+            } else {
+                // Parking plein à l'arrivée : toute l'approche est perdue
+                stats.wastedDistance += ApproachDriven(car, car, state.approachStart[i], state.network);
+                stats.failedSearches++;
+                car.parkingIdx = -1;
+            }
+        }
+
+        if (intent & INTENT_EXIT) {
+            // Une seule sortie à la fois par parking
+            if (!parkings[car.parkingIdx].leaving.empty()) {
+                car.waitTimer = 1.0f;
+            } else {
+                car.state = LEAVING_PARKING;
+            }
+        }
+
+        if (intent & INTENT_RELEASE_SPOT) {
+            if (before.parkingIdx >= 0 && before.parkingIdx < lotCount) {
+                parkings[before.parkingIdx].freeSpot(before.spotIdx);
+                state.lots.update(before.parkingIdx, parkings[before.parkingIdx]);
+            }
+        }
+
+        UpdateLotRegistry(i, before, car, parkings, state.registrySlot);
+    }
+}
+
+void SyncLaneIndex(const std::vector<Car>& cars, const std::vector<Road>& roads, TrafficState& state) {
+    if (state.activeCars == (int)cars.size() && state.fleetEdits == state.fleetEditsSeen)
+        state.index.sync(cars, roads, state.active);
+    else
+        state.index.sync(cars, roads);
+}
+
+void NoteFleetEdit(TrafficState& state) {
+    state.fleetEdits++;
+}
+
+// Car n'a pas de rembourrage : deux copies identiques le sont octet par octet
+static bool SameCar(const Car& a, const Car& b) {
+    return std::memcmp(&a, &b, sizeof(Car)) == 0;
+}
+
+// Voitures endormies modifiées hors du tick (différentes de leur copie du tampon arrière) :
+// réveillées tout de suite, avec le reste de leur attente si elle n'a pas été changée
+static void WakeEditedCars(std::vector<Car>& cars, TrafficState& state) {
+    TimingWheel& wheel = state.parkedWheel;
+    const int n = (int)cars.size();
+    for (int i = 0; i < n && wheel.size() > 0; i++) {
+        if (!wheel.scheduled(i) || SameCar(cars[i], state.next[i])) continue;
+        if (cars[i].waitTimer == state.next[i].waitTimer)
+            cars[i].waitTimer = (float)std::max(wheel.deadlineOf(i) - wheel.now(), 0.0);
+        wheel.cancel(i);
+        state.woken.push_back(i);
+    }
+}
+
+// Voitures actives du tick : celles du tick précédent qui ne se sont pas endormies, plus
+// les réveils dus d'ici la fin du tick et les voitures endormies modifiées depuis (après
+// NoteFleetEdit). Flotte changée de taille : tout le monde, roue vidée.
+static void WakeParkedCars(std::vector<Car>& cars, double tickEnd, TrafficState& state) {
+    const int n = (int)cars.size();
+    TimingWheel& wheel = state.parkedWheel;
+    if (state.activeCars != n) {
+        wheel.clear(n, wheel.now());
+        state.active.resize(n);
+        for (int i = 0; i < n; i++) state.active[i] = i;
+        state.activeCars = n;
+    } else {
+        state.active.erase(std::remove_if(state.active.begin(), state.active.end(),
+                                          [&](int i) { return wheel.scheduled(i); }),
+                           state.active.end());
+    }
+
+    state.woken.clear();
+    if (state.fleetEdits != state.fleetEditsSeen) {
+        WakeEditedCars(cars, state);
+        state.fleetEditsSeen = state.fleetEdits;
+    }
+#ifndef NDEBUG
+    // Modification sur place sans NoteFleetEdit : la voiture endormie ne la verrait pas
+    for (int i = 0; i < n; i++)
+        assert(!wheel.scheduled(i) || SameCar(cars[i], state.next[i]));
+#endif
+    const size_t edited = state.woken.size();
+    wheel.advance(tickEnd, state.woken);
+    if (state.woken.empty()) return;
+
+    // Attente écoulée : la voiture reprend au contrôle de sortie (DecideParked)
+    for (size_t k = edited; k < state.woken.size(); k++) cars[state.woken[k]].waitTimer = 0.0f;
+    std::sort(state.woken.begin(), state.woken.end());
+    size_t mid = state.active.size();
+    state.active.insert(state.active.end(), state.woken.begin(), state.woken.end());
+    std::inplace_merge(state.active.begin(), state.active.begin() + mid, state.active.end());
+}
+
+// Mise à jour principale de la simulation
+static void TrafficTick(std::vector<Car>& cars, std::vector<Road>& roads,
+                        std::vector<ParkingLot>& parkings, float dt, TrafficState& state) {
+    const int n = (int)cars.size();
+    const size_t grain = 256;
+
+    // Index (route, voie) -> voitures triées par distance (état du tick précédent).
+    // La flotte n'est pas triée : les indices restent des handles stables d'un tick à l'autre.
+    {
+        ProfileScope scope(PROF_LANE_SORT);
+        SyncLaneIndex(cars, roads, state);
+    }
+
+    // Géométrie du réseau (précalculée une fois, puis à chaque changement du nombre de routes/parkings)
+    if (!state.network.matches(roads, parkings)) {
+        state.network.build(roads, parkings);
+        state.lots.build(state.network, parkings);
+        if (state.dynamicPricing) state.pricing.build(parkings);
+    }
+    // Tarifs révisés d'après l'occupation, avant la relecture des parkings disponibles
+    if (state.dynamicPricing) {
+        if (!state.pricing.matches(parkings)) state.pricing.build(parkings);
+        state.pricing.update(dt, parkings);
+    }
+    // Parkings disponibles : ceux dont l'occupation ou le prix a changé hors du tick
+    if (!state.lots.matches(parkings)) state.lots.build(state.network, parkings);
+    else state.lots.refresh(parkings);
+
+    // Feux : seuls ceux dont le changement est dû au temps simulé sont touchés
+    // (les carrefours adaptatifs mesurent leurs files sur l'index à jour)
+    {
+        ProfileScope scope(PROF_LIGHTS);
+        if (!state.signals.matches(roads)) state.signals.build(roads, state.network);
+        state.signals.update(dt, roads, cars, state.index);
+    }
+
+    // Seules les voitures actives passent par les trois phases : une voiture garée dort
+    // dans la roue jusqu'à la fin de son attente
+    const double tickEnd = state.parkedWheel.now() + dt;
+    WakeParkedCars(cars, tickEnd, state);
+    const std::vector<int>& active = state.active;
+    const int m = (int)active.size();
+
+    // Cinématique DRIVING en SoA : la décision fixe les consignes, le noyau les applique
+    state.kin.loadHot(cars, active);
+    state.next.resize(n);
+    state.perception.resize(n);
+    state.intents.resize(n);
+    state.approachStart.resize(n);
+    state.carIds.resize(m);
+    state.parkRoll.resize(m);
+    state.dwell.resize(m);
+
+    // Registre des manœuvres par parking, tenu à jour par l'application des actions
+    if (state.registryCars != n) {
+        RebuildLotRegistry(cars, parkings, state.registrySlot);
+        state.registryCars = n;
+    }
+
+    for (int k = 0; k < m; k++) state.carIds[k] = (uint32_t)cars[active[k]].id;
+
+    // Phase 1 : tirages aléatoires (fonction pure de (graine, id, tick), en lot) et perception
+    {
+        ProfileScope scope(PROF_SENSE);
+        state.pool.parallelFor(m, grain, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("perception (tranche)");
+            const uint32_t* ids = state.carIds.data() + begin;
+            CounterRangeBatch(state.seed, ids, end - begin, state.tick, DRAW_PARK_ROLL, 0, 500,
+                              state.parkRoll.data() + begin);
+            CounterRangeBatch(state.seed, ids, end - begin, state.tick, DRAW_DWELL, 15, 25,
+                              state.dwell.data() + begin);
+            for (size_t k = begin; k < end; k++)
+                state.perception[active[k]] = SenseCar(active[k], cars, parkings, state, dt);
+        });
+    }
+
+    // Enregistrement des trajectoires : la case de l'anneau est remplie pendant la phase 2,
+    // tant que les voitures viennent d'être écrites (en cache) ; l'encodage se fait sur le
+    // thread d'écriture
+    TrajectoryFrame* snapshot = state.recorder ? state.recorder->beginFrame(state.tick, n) : nullptr;
+
+    // Phase 2 : décision / action dans le tampon arrière, puis noyau cinématique sur les
+    // indices de la tranche (les voitures endormies entre deux actives ne sont pas DRIVING)
+    {
+        ProfileScope scope(PROF_DECIDE);
+        state.pool.parallelFor(m, grain, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("decision (tranche)");
+            for (size_t k = begin; k < end; k++)
+                DecideCar((int)k, cars, roads, parkings, state, dt);
+            IntegrateKinematics(state.kin, dt, active[begin], active[end - 1] + 1);
+            for (size_t k = begin; k < end; k++)
+                ApplyKinematics(active[k], state);
+            // Les voitures endormies jusqu'à la tranche suivante sont enregistrées avec celle-ci
+            if (snapshot)
+                TrajectoryRecorder::capture(*snapshot, state.next, (begin == 0) ? 0 : active[begin],
+                                            (end == (size_t)m) ? n : active[end]);
+        });
+        if (snapshot && m == 0) TrajectoryRecorder::capture(*snapshot, state.next, 0, n);
+    }
+
+    // Phase 3 : application des actions sur les parkings, puis échange des tampons
+    ProfileScope scope(PROF_COMMIT);
+    CommitIntents(cars, parkings, state);
+    if (snapshot) {
+        // Seules les voitures avec une action ont pu changer pendant l'application
+        for (int i : active)
+            if (state.intents[i] != INTENT_NONE) TrajectoryRecorder::capture(*snapshot, state.next, i, i + 1);
+        state.recorder->publish();
+    }
+    // Voiture qui reste garée avec une attente : endormie jusqu'à l'échéance, et recopiée
+    // dans le tampon avant (elle n'est plus écrite d'ici son réveil)
+    for (int i : active) {
+        const Car& car = state.next[i];
+        if (car.state == PARKED && car.waitTimer > 0) {
+            cars[i] = car;
+            state.parkedWheel.schedule(i, tickEnd + car.waitTimer);
+        }
+    }
+    cars.swap(state.next);
+    state.tick++;
+}
+
+// Un tick = un enregistrement du profileur (phases chronométrées dans TrafficTick)
+void UpdateTraffic(std::vector<Car>& cars, std::vector<Road>& roads,
+                   std::vector<ParkingLot>& parkings, float dt, TrafficState& state) {
+    {
+        ProfileScope scope(PROF_TICK);
+        TrafficTick(cars, roads, parkings, dt, state);
+    }
+    GlobalProfiler().endRecord(PROF_TRACK_SIM);
+}
+
+// Exécute un pas fixe (découpé en sous-pas)
+static void FixedStep(std::vector<Car>& cars, std::vector<Road>& roads,
+                      std::vector<ParkingLot>& parkings, TrafficState& state) {
+    SimClock& clock = state.clock;
+    int substeps = std::max(1, clock.substeps);
+    float subDt = (float)(clock.fixedDt / substeps);
+    for (int k = 0; k < substeps; k++)
+        UpdateTraffic(cars, roads, parkings, subDt, state);
+    clock.accumulator -= clock.fixedDt;
+    clock.time += clock.fixedDt;
+    clock.tick++;
+}
+
+// Tolérance sur l'accumulateur : une somme de trames qui vaut exactement N pas
+// doit donner N pas malgré les arrondis
+static bool StepDue(const SimClock& clock) {
+    return clock.accumulator >= clock.fixedDt * (1.0 - 1e-6);
+}
+
+int StepSimulation(std::vector<Car>& cars, std::vector<Road>& roads,
+                   std::vector<ParkingLot>& parkings, float frameDt, TrafficState& state) {
+    TRACE_SCOPE("pas fixes");
+    SimClock& clock = state.clock;
+    if (frameDt > 0) clock.accumulator += frameDt;
+
+    int steps = 0;
+    while (StepDue(clock)) {
+        if (steps >= clock.maxStepsPerFrame) {
+            // Trop de retard : on abandonne le reste plutôt que de geler l'affichage
+            clock.droppedTime += clock.accumulator;
+            clock.accumulator = 0.0;
+            break;
+        }
+        FixedStep(cars, roads, parkings, state);
+        steps++;
+    }
+    return steps;
+}
+
+int64_t RunSimulation(std::vector<Car>& cars, std::vector<Road>& roads,
+                      std::vector<ParkingLot>& parkings, double seconds, TrafficState& state) {
+    SimClock& clock = state.clock;
+    if (seconds > 0) clock.accumulator += seconds;
+
+    int64_t steps = 0;
+    while (StepDue(clock)) {
+        FixedStep(cars, roads, parkings, state);
+        steps++;
+    }
+    return steps;
+}
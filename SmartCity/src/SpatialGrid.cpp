@@ -0,0 +1,103 @@
+#include "../include/SpatialGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+int SpatialGrid::cellX(float x) const {
+    int c = (int)std::floor((x - worldExtent.minX) / cell);
+    return std::min(std::max(c, 0), cols - 1);
+}
+
+int SpatialGrid::cellY(float y) const {
+    int c = (int)std::floor((y - worldExtent.minY) / cell);
+    return std::min(std::max(c, 0), rows - 1);
+}
+
+void SpatialGrid::build(const std::vector<Bounds>& newBoxes, float cellSize) {
+    boxes = newBoxes;
+    stamp.assign(boxes.size(), 0);
+    queryStamp = 0;
+    cellStart.clear();
+    items.clear();
+    cols = rows = 0;
+    if (boxes.empty()) return;
+
+    worldExtent = boxes[0];
+    for (const Bounds& b : boxes) {
+        worldExtent.minX = std::min(worldExtent.minX, b.minX);
+        worldExtent.minY = std::min(worldExtent.minY, b.minY);
+        worldExtent.maxX = std::max(worldExtent.maxX, b.maxX);
+        worldExtent.maxY = std::max(worldExtent.maxY, b.maxY);
+    }
+    float width = std::max(worldExtent.maxX - worldExtent.minX, 1.0f);
+    float height = std::max(worldExtent.maxY - worldExtent.minY, 1.0f);
+    cell = std::max(cellSize > 0.0f ? cellSize : DEFAULT_CELL_SIZE, std::max(width, height) / MAX_CELLS_PER_AXIS);
+    cols = std::min(MAX_CELLS_PER_AXIS, (int)(width / cell) + 1);
+    rows = std::min(MAX_CELLS_PER_AXIS, (int)(height / cell) + 1);
+
+    // Comptage puis rangement (deux passes, pas de liste par cellule)
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    for (const Bounds& b : boxes) {
+        for (int y = cellY(b.minY); y <= cellY(b.maxY); y++)
+            for (int x = cellX(b.minX); x <= cellX(b.maxX); x++) cellStart[y * cols + x + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+    items.resize(cellStart.back());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const Bounds& b = boxes[i];
+        for (int y = cellY(b.minY); y <= cellY(b.maxY); y++)
+            for (int x = cellX(b.minX); x <= cellX(b.maxX); x++) items[fill[y * cols + x]++] = (int)i;
+    }
+}
+
+void SpatialGrid::query(const Bounds& zone, std::vector<int>& out) const {
+    out.clear();
+    if (boxes.empty() || !zone.overlaps(worldExtent)) return;
+
+    int x0 = cellX(zone.minX), x1 = cellX(zone.maxX);
+    int y0 = cellY(zone.minY), y1 = cellY(zone.maxY);
+
+    // Zone couvrant toute la grille (vue dézoomée) : parcours direct, déjà dans l'ordre
+    if (x0 == 0 && y0 == 0 && x1 == cols - 1 && y1 == rows - 1) {
+        for (size_t i = 0; i < boxes.size(); i++)
+            if (boxes[i].overlaps(zone)) out.push_back((int)i);
+        return;
+    }
+
+    if (++queryStamp == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        queryStamp = 1;
+    }
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            int c = y * cols + x;
+            for (int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                int i = items[k];
+                if (stamp[i] == queryStamp) continue;
+                stamp[i] = queryStamp;
+                if (boxes[i].overlaps(zone)) out.push_back(i);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+
+bool ClipSegment(Vec2 a, Vec2 b, const Bounds& box, float& t0, float& t1) {
+    t0 = 0.0f;
+    t1 = 1.0f;
+    const float d[2] = { b.x - a.x, b.y - a.y };
+    const float lo[2] = { box.minX - a.x, box.minY - a.y };
+    const float hi[2] = { box.maxX - a.x, box.maxY - a.y };
+    for (int axis = 0; axis < 2; axis++) {
+        if (d[axis] == 0.0f) {
+            if (lo[axis] > 0.0f || hi[axis] < 0.0f) return false;
+            continue;
+        }
+        float ta = lo[axis] / d[axis], tb = hi[axis] / d[axis];
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+#include "../include/SpotBitmap.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static inline int CountTrailingZeros64(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return (int)idx;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+static const uint64_t FULL_WORD = ~0ull;
+
+void SpotBitmap::resize(int cap) {
+    capacity = cap > 0 ? cap : 0;
+    occupied = 0;
+    levels.clear();
+
+    // Construit les niveaux jusqu'à tenir dans un seul mot
+    int bits = capacity;
+    do {
+        int words = (bits + 63) / 64;
+        if (words == 0) words = 1;
+        std::vector<uint64_t> level(words, 0);
+        // Bits de remplissage au-delà de la fin : considérés occupés
+        if (bits % 64 != 0 || bits == 0) level[words - 1] = FULL_WORD << (bits % 64);
+        levels.push_back(level);
+        bits = words;
+    } while (bits > 1);
+
+    // Un mot de remplissage entièrement plein doit être signalé au niveau supérieur
+    for (size_t k = 0; k + 1 < levels.size(); k++) {
+        for (size_t w = 0; w < levels[k].size(); w++) {
+            if (levels[k][w] == FULL_WORD) levels[k + 1][w >> 6] |= 1ull << (w & 63);
+        }
+    }
+}
+
+void SpotBitmap::set(int idx) {
+    if (idx < 0 || idx >= capacity || test(idx)) return;
+    occupied++;
+    size_t pos = (size_t)idx;
+    for (size_t k = 0; k < levels.size(); k++) {
+        uint64_t& word = levels[k][pos >> 6];
+        word |= 1ull << (pos & 63);
+        if (word != FULL_WORD) break; // le niveau supérieur ne change pas
+        pos >>= 6;
+    }
+}
+
+void SpotBitmap::reset(int idx) {
+    if (idx < 0 || idx >= capacity || !test(idx)) return;
+    occupied--;
+    size_t pos = (size_t)idx;
+    for (size_t k = 0; k < levels.size(); k++) {
+        uint64_t& word = levels[k][pos >> 6];
+        bool wasFull = (word == FULL_WORD);
+        word &= ~(1ull << (pos & 63));
+        if (!wasFull) break; // le mot n'était pas plein : le niveau supérieur le savait déjà
+        pos >>= 6;
+    }
+}
+
+int SpotBitmap::findFirstFree() const {
+    if (full()) return -1;
+    // Descente depuis le sommet : premier bit à 0 de chaque niveau
+    size_t pos = 0;
+    for (size_t k = levels.size(); k-- > 0;) {
+        uint64_t free = ~levels[k][pos];
+        if (free == 0) return -1;
+        pos = (pos << 6) + CountTrailingZeros64(free);
+    }
+    return (int)pos;
+}
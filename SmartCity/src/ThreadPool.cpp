@@ -0,0 +1,77 @@
+#include "../include/ThreadPool.hpp"
+#include "../include/Trace.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount) {
+    for (int i = 1; i < threadCount; i++) workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+// Chaque participant prend des tranches tant qu'il en reste
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t begin = nextChunk.fetch_add(jobGrain);
+        if (begin >= jobCount) return;
+        (*job)(begin, std::min(jobCount, begin + jobGrain));
+    }
+}
+
+void ThreadPool::workerLoop() {
+    TRACE_THREAD("pool");
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        {
+            TRACE_SCOPE("tranches");
+            runChunks();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        done.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    // Pas de threads ou travail trop petit : exécution directe
+    if (workers.empty() || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        nextChunk = 0;
+        busyWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks();
+
+    // Attente des tranches encore en cours sur les autres threads
+    TRACE_SCOPE("attente du pool");
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,84 @@
+#include "../include/TimingWheel.hpp"
+#include <algorithm>
+#include <cmath>
+
+const int64_t WHEEL_MASK = WHEEL_SLOTS - 1;
+
+void TimingWheel::clear(int count, double now) {
+    for (auto& b : fine) b.clear();
+    for (auto& b : coarse) b.clear();
+    overflow.clear();
+    deadline.assign(count, -1.0);
+    time = now;
+    cursor = slotOf(now);
+    pending = 0;
+}
+
+int64_t TimingWheel::slotOf(double t) const {
+    return (int64_t)std::floor(t / WHEEL_RESOLUTION);
+}
+
+// Roue fine si l'échéance tombe dans le tour en cours, grossière dans le grand tour en cours,
+// sinon liste d'attente (une échéance passée va dans la case courante)
+void TimingWheel::place(const Entry& e) {
+    int64_t s = std::max(slotOf(e.when), cursor);
+    if ((s >> WHEEL_BITS) == (cursor >> WHEEL_BITS))
+        fine[s & WHEEL_MASK].push_back(e);
+    else if ((s >> (2 * WHEEL_BITS)) == (cursor >> (2 * WHEEL_BITS)))
+        coarse[(s >> WHEEL_BITS) & WHEEL_MASK].push_back(e);
+    else
+        overflow.push_back(e);
+}
+
+void TimingWheel::schedule(int id, double when) {
+    when = std::max(when, 0.0);
+    if (deadline[id] == when) return;
+    if (!scheduled(id)) pending++;
+    deadline[id] = when;
+    place({id, when});
+}
+
+void TimingWheel::cancel(int id) {
+    if (!scheduled(id)) return;
+    deadline[id] = -1.0;
+    pending--;
+}
+
+// Redescend les entrées d'une case d'une roue, sans les entrées périmées
+void TimingWheel::cascade(std::vector<Entry>& bucket) {
+    scratch.swap(bucket);
+    for (const Entry& e : scratch)
+        if (live(e)) place(e);
+    scratch.clear();
+}
+
+void TimingWheel::advance(double now, std::vector<int>& due) {
+    time = std::max(time, now);
+    const int64_t target = std::max(slotOf(time), cursor);
+
+    for (int64_t s = cursor;; s++) {
+        if (s != cursor) {
+            // Entrée dans une nouvelle case : au début d'un tour, les échéances de ce tour
+            // descendent d'une roue (liste d'attente -> grossière -> fine)
+            cursor = s;
+            if ((s & ((WHEEL_MASK << WHEEL_BITS) | WHEEL_MASK)) == 0) cascade(overflow);
+            if ((s & WHEEL_MASK) == 0) cascade(coarse[(s >> WHEEL_BITS) & WHEEL_MASK]);
+        }
+
+        // Case courante : seules les échéances pas encore atteintes y restent (dernière case)
+        std::vector<Entry>& b = fine[s & WHEEL_MASK];
+        size_t keep = 0;
+        for (const Entry& e : b) {
+            if (!live(e)) continue;
+            if (e.when <= time) {
+                deadline[e.id] = -1.0;
+                pending--;
+                due.push_back(e.id);
+            } else {
+                b[keep++] = e;
+            }
+        }
+        b.resize(keep);
+        if (s == target) break;
+    }
+}
@@ -0,0 +1,135 @@
+#include "../include/Trace.hpp"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start;     // ns
+    uint64_t duration;  // ns
+};
+
+// Tampon d'un thread : seul son thread y écrit ; le mutex n'est disputé que pendant
+// un export ou un vidage (prise quasi gratuite le reste du temps)
+struct TraceBuffer {
+    int tid = 0;
+    std::string name;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;     // anneau de TRACE_BUFFER_EVENTS au plus
+    uint64_t written = 0;               // événements reçus depuis le dernier vidage
+};
+
+// Registre des tampons : ils survivent à leur thread pour l'export
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+
+static TraceBuffer& ThreadBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer()));
+        buffer = registry.back().get();
+        buffer->tid = (int)registry.size();
+        buffer->name = "thread " + std::to_string(buffer->tid);
+    }
+    return *buffer;
+}
+
+uint64_t TraceNow() {
+    using namespace std::chrono;
+    static const steady_clock::time_point epoch = steady_clock::now();
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+}
+
+void TraceRecord(const char* name, uint64_t start, uint64_t end) {
+    TraceBuffer& b = ThreadBuffer();
+    TraceEvent e = { name, start, end - start };
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (b.events.size() < TRACE_BUFFER_EVENTS) b.events.push_back(e);
+    else b.events[b.written % TRACE_BUFFER_EVENTS] = e;
+    b.written++;
+}
+
+void TraceThreadName(const char* name) {
+    TraceBuffer& b = ThreadBuffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.name = name;
+}
+
+// Les noms viennent du code, mais un guillemet ou un antislash casserait le JSON
+static void WriteJsonString(std::ofstream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\';
+        if ((unsigned char)c >= 0x20) out << c;
+    }
+    out << '"';
+}
+
+bool WriteChromeTrace(const std::string& path, std::string& error) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        error = path + " : ecriture impossible";
+        return false;
+    }
+
+    // Copie de chaque tampon sous son verrou : les threads continuent d'écrire pendant l'export
+    std::vector<TraceEvent> events;
+    std::string name;
+    int tid = 0;
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    for (const auto& buffer : registry) {
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            tid = buffer->tid;
+            name = buffer->name;
+            // Anneau plein : les plus anciens commencent à la prochaine case écrite
+            size_t oldest = (buffer->events.size() < TRACE_BUFFER_EVENTS) ? 0 : (size_t)(buffer->written % TRACE_BUFFER_EVENTS);
+            events.assign(buffer->events.begin() + oldest, buffer->events.end());
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + oldest);
+        }
+
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":";
+        WriteJsonString(out, name);
+        out << "}}";
+        first = false;
+
+        // Horodatage en microsecondes (fractions gardées)
+        for (const TraceEvent& e : events) {
+            out << ",\n{\"name\":";
+            WriteJsonString(out, e.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << e.start / 1000 << "."
+                << (e.start % 1000) / 100 << ",\"dur\":" << e.duration / 1000 << "." << (e.duration % 1000) / 100 << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        error = path + " : ecriture impossible";
+        return false;
+    }
+    return true;
+}
+
+size_t TraceEventCount() {
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    size_t count = 0;
+    for (const auto& buffer : registry) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+void ClearTrace() {
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    for (const auto& buffer : registry) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->written = 0;
+    }
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "../include/Scenario.hpp"
+
+// ---------------------------
+//  Compilation d'un scénario texte en scénario binaire (.scb)
+//  Usage : ScenarioCompiler <scenario.txt> <scenario.scb>
+//          ScenarioCompiler --info <scenario.scb|txt>
+// ---------------------------
+
+static double Milliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int Info(const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenario(path, scenario, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    int spots = 0;
+    for (const auto& p : scenario.parkings) spots += p.capacity;
+    std::cout << path << " : " << scenario.roads.size() << " routes, " << scenario.parkings.size()
+              << " parkings (" << spots << " places), " << scenario.cars.size() << " voitures, graine "
+              << scenario.seed << (scenario.mapping.isOpen() ? " [binaire v" : " [texte")
+              << (scenario.mapping.isOpen() ? std::to_string(scenario.mapping.header().version) : "")
+              << "], charge en " << Milliseconds(start) << " ms" << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]) == "--info") return Info(argv[2]);
+    if (argc != 3) {
+        std::cerr << "Usage : " << argv[0] << " <scenario.txt> <scenario.scb>\n"
+                  << "        " << argv[0] << " --info <scenario>" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Scenario scenario;
+    std::string error;
+    if (!LoadScenarioText(argv[1], scenario, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << argv[1] << " lu en " << Milliseconds(start) << " ms" << std::endl;
+
+    if (!SaveScenarioBinary(argv[2], scenario.seed, scenario.roads, scenario.parkings, scenario.cars, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    // Relecture du résultat (vérifie le fichier et mesure le chargement projeté)
+    return Info(argv[2]);
+}